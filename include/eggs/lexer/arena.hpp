@@ -0,0 +1,174 @@
+//! \file eggs/lexer/arena.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_ARENA_HPP
+#define EGGS_LEXER_ARENA_HPP
+
+#include <eggs/lexer/token.hpp>
+#include <eggs/lexer/tokenize.hpp>
+
+#include <cstddef>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+namespace eggs { namespace lexers
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! class value_arena;
+    //!
+    //! Class `value_arena` represents a `std::pmr::monotonic_buffer_resource`
+    //! that keeps count of the bytes allocated from it. It is meant to own
+    //! the associated values of the tokens of a lexing session, which can
+    //! then be discarded without visiting each of them.
+    //!
+    //! \remarks A `value_arena` is not safe to use concurrently.
+    class value_arena
+      : public std::pmr::monotonic_buffer_resource
+    {
+    public:
+        //! value_arena();
+        //!
+        //! \effects Equivalent to `value_arena(4096)`.
+        value_arena()
+          : value_arena(4096)
+        {}
+
+        //! explicit value_arena(std::size_t initial_size);
+        //!
+        //! \effects Initializes an empty arena whose first block holds at
+        //!  least `initial_size` bytes. No memory is allocated.
+        explicit value_arena(std::size_t initial_size)
+          : std::pmr::monotonic_buffer_resource(initial_size)
+          , _used(0)
+        {}
+
+        //! void release();
+        //!
+        //! \effects Equivalent to
+        //!  `std::pmr::monotonic_buffer_resource::release()`, and resets the
+        //!  count of bytes allocated.
+        void release()
+        {
+            std::pmr::monotonic_buffer_resource::release();
+            _used = 0;
+        }
+
+        //! std::size_t bytes_allocated() const noexcept;
+        //!
+        //! \returns The number of bytes allocated since construction or the
+        //!  last call to `release()`.
+        std::size_t bytes_allocated() const noexcept
+        {
+            return _used;
+        }
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            void* const ptr =
+                std::pmr::monotonic_buffer_resource::do_allocate(
+                    bytes, alignment);
+            _used += bytes;
+            return ptr;
+        }
+
+    private:
+        std::size_t _used;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Rule, class T = void>
+    //! class arena_rule;
+    //!
+    //! Class template `arena_rule` represents a tokenization rule adaptor
+    //! that demarcates tokens as `Rule` does, and constructs their associated
+    //! values of type `T` within a memory resource, typically a
+    //! `value_arena`. The associated value of a token is then a `T*` into the
+    //! resource, so that tokens are trivially destructible and discarding
+    //! them takes no time; the values themselves live until the resource
+    //! releases them. If `T` is `void`, it is the
+    //! associated value type of `Rule`.
+    //!
+    //! \requires `Rule` shall satisfy TokenizationRule, and its tokens shall
+    //!  have an associated value. `T` shall be constructible from it by
+    //!  uses-allocator construction with a
+    //!  `std::pmr::polymorphic_allocator`.
+    //!
+    //! \remarks Destructors of the associated values are never run, which is
+    //!  harmless when `T` is trivially destructible or allocates only from
+    //!  the given allocator (e.g. `std::pmr::string`).
+    template <typename Rule, typename T = void>
+    class arena_rule
+    {
+    public:
+        //! explicit arena_rule(std::pmr::memory_resource& resource, Rule rule = Rule());
+        //!
+        //! \effects Initializes the adapted rule with `std::move(rule)`, and
+        //!  refers to `resource` for the storage of associated values.
+        explicit arena_rule(
+            std::pmr::memory_resource& resource, Rule rule = Rule())
+          : _resource(&resource)
+          , _rule(std::move(rule))
+        {}
+
+        //! template <class Iterator, class Sentinel>
+        //! decltype(auto) operator()(Iterator first, Sentinel last) const;
+        //!
+        //! \effects Equivalent to `return rule(first, last);`.
+        template <typename Iterator, typename Sentinel>
+        decltype(auto) operator()(Iterator first, Sentinel last) const
+        {
+            return _rule(first, last);
+        }
+
+        //! template <class Iterator, class Payload>
+        //! auto evaluate(token<Iterator, Payload>&& token) const;
+        //!
+        //! \effects Evaluates the associated value of `token` as `Rule`
+        //!  would, and constructs an object of type `T` from it within the
+        //!  memory resource.
+        //!
+        //! \returns A pointer to the constructed object.
+        template <typename Iterator, typename Payload>
+        auto evaluate(token<Iterator, Payload>&& token) const
+        {
+            auto const evaluate = [&]() -> decltype(auto)
+            {
+                if constexpr (std::is_void_v<Payload>)
+                {
+                    return detail::evaluate(_rule,
+                        token.category(), token.first, token.second,
+                        detail::empty{});
+                } else {
+                    return detail::evaluate(_rule,
+                        token.category(), token.first, token.second,
+                        std::move(token.value));
+                }
+            };
+            static_assert(!std::is_void_v<decltype(evaluate())>,
+                "the adapted rule shall have an associated value");
+
+            auto&& value = evaluate();
+            using value_type = std::decay_t<decltype(value)>;
+
+            using object_type =
+                std::conditional_t<std::is_void_v<T>, value_type, T>;
+            std::pmr::polymorphic_allocator<object_type> alloc(_resource);
+            object_type* const object = alloc.allocate(1);
+            alloc.construct(object, std::forward<decltype(value)>(value));
+            return object;
+        }
+
+    private:
+        std::pmr::memory_resource* _resource;
+        Rule _rule;
+    };
+}}
+
+#endif /*EGGS_LEXER_ARENA_HPP*/
@@ -0,0 +1,258 @@
+//! \file eggs/lexer/char_set.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_CHAR_SET_HPP
+#define EGGS_LEXER_CHAR_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+namespace eggs { namespace lexers
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! class char_set;
+    //!
+    //! Class `char_set` represents a set of byte-sized characters, suitable
+    //! for constant time membership tests while scanning an input range.
+    class char_set
+    {
+    public:
+        //! constexpr char_set() noexcept;
+        //!
+        //! \effects Initializes an empty set.
+        constexpr char_set() noexcept
+          : _bits{}
+        {}
+
+        //! constexpr char_set(char const* chars) noexcept;
+        //!
+        //! \requires `chars` shall point to a null-terminated byte string.
+        //!
+        //! \effects Initializes a set with each of the characters in `chars`.
+        constexpr char_set(char const* chars) noexcept
+          : _bits{}
+        {
+            while (*chars != '\0')
+                insert(*chars++);
+        }
+
+        //! constexpr char_set& insert(char c) noexcept;
+        //!
+        //! \effects Adds `c` to the set.
+        //!
+        //! \returns `*this`.
+        constexpr char_set& insert(char c) noexcept
+        {
+            unsigned char const uc = static_cast<unsigned char>(c);
+            _bits[uc / 64] |= std::uint64_t(1) << (uc % 64);
+            return *this;
+        }
+
+        //! constexpr char_set& insert(char first, char last) noexcept;
+        //!
+        //! \requires `static_cast<unsigned char>(first)` shall not be greater
+        //!  than `static_cast<unsigned char>(last)`.
+        //!
+        //! \effects Adds each character in the closed interval `[first, last]`
+        //!  to the set.
+        //!
+        //! \returns `*this`.
+        constexpr char_set& insert(char first, char last) noexcept
+        {
+            unsigned char uc = static_cast<unsigned char>(first);
+            for (; uc != static_cast<unsigned char>(last); ++uc)
+                insert(static_cast<char>(uc));
+            return insert(last);
+        }
+
+        //! constexpr bool contains(char c) const noexcept;
+        //!
+        //! \returns `true` if `c` is in the set; otherwise, `false`.
+        constexpr bool contains(char c) const noexcept
+        {
+            unsigned char const uc = static_cast<unsigned char>(c);
+            return (_bits[uc / 64] >> (uc % 64)) & 1;
+        }
+
+        //! constexpr std::size_t size() const noexcept;
+        //!
+        //! \returns The number of characters in the set.
+        constexpr std::size_t size() const noexcept
+        {
+            std::size_t count = 0;
+            for (std::uint64_t bits : _bits)
+                for (; bits != 0; bits &= bits - 1)
+                    ++count;
+            return count;
+        }
+
+        //! constexpr bool empty() const noexcept;
+        //!
+        //! \returns `size() == 0`.
+        constexpr bool empty() const noexcept
+        {
+            return (_bits[0] | _bits[1] | _bits[2] | _bits[3]) == 0;
+        }
+
+        //! constexpr char front() const noexcept;
+        //!
+        //! \preconditions `empty()` is `false`.
+        //!
+        //! \returns The smallest character in the set, when considered as an
+        //!  `unsigned char`.
+        constexpr char front() const noexcept
+        {
+            for (unsigned i = 0; i < 256; ++i)
+                if ((_bits[i / 64] >> (i % 64)) & 1)
+                    return static_cast<char>(i);
+            return '\0';
+        }
+
+        //! friend constexpr char_set operator|(char_set const& lhs, char_set const& rhs) noexcept;
+        //!
+        //! \returns A set with the characters that are in either `lhs` or
+        //!  `rhs`.
+        friend constexpr char_set operator|(
+            char_set const& lhs, char_set const& rhs) noexcept
+        {
+            char_set result;
+            for (std::size_t i = 0; i < 4; ++i)
+                result._bits[i] = lhs._bits[i] | rhs._bits[i];
+            return result;
+        }
+
+    private:
+        std::uint64_t _bits[4];
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! class char_class_rule;
+    //!
+    //! Class `char_class_rule` is a Tokenization Rule that demarcates the
+    //! longest non-empty run of characters in a `char_set`.
+    //!
+    //! \remarks Lexers constituted solely by rules of, or derived from,
+    //!  `char_class_rule` can demarcate tokens of many inputs at once with
+    //!  `lexer::tokenize_lanes`.
+    class char_class_rule
+    {
+    public:
+        //! constexpr explicit char_class_rule(char_set const& set) noexcept;
+        //!
+        //! \effects Initializes the rule to demarcate runs of characters in
+        //!  `set`.
+        constexpr explicit char_class_rule(char_set const& set) noexcept
+          : _set(set)
+        {}
+
+        //! template <class Iterator, class Sentinel>
+        //! Iterator operator()(Iterator first, Sentinel last) const;
+        //!
+        //! \returns An iterator past the longest prefix of `[first, last)`
+        //!  whose characters are in the set.
+        template <typename Iterator, typename Sentinel>
+        Iterator operator()(Iterator first, Sentinel last) const
+        {
+            while (first != last && _set.contains(*first))
+                ++first;
+            return first;
+        }
+
+        //! constexpr char_set const& set() const noexcept;
+        //!
+        //! \returns The set of characters of the rule.
+        constexpr char_set const& set() const noexcept
+        {
+            return _set;
+        }
+
+    private:
+        char_set _set;
+    };
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <typename Iterator, typename Sentinel>
+        Iterator find_first_of(
+            Iterator first, Sentinel last, char_set const& set)
+        {
+            while (first != last && !set.contains(*first))
+                ++first;
+            return first;
+        }
+
+        template <typename Char, typename = std::enable_if_t<sizeof(Char) == 1>>
+        Char const* find_first_of(
+            Char const* first, Char const* last, char_set const& set)
+        {
+            if (set.size() == 1)
+            {
+                void const* const found = std::memchr(
+                    first, set.front(), static_cast<std::size_t>(last - first));
+                return found != nullptr
+                  ? static_cast<Char const*>(found) : last;
+            }
+
+            while (first != last && !set.contains(*first))
+                ++first;
+            return first;
+        }
+
+        template <typename Char, typename = std::enable_if_t<sizeof(Char) == 1>>
+        Char* find_first_of(
+            Char* first, Char* last, char_set const& set)
+        {
+            return const_cast<Char*>(detail::find_first_of(
+                static_cast<Char const*>(first), static_cast<Char const*>(last),
+                set));
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename Iterator>
+        Iterator find_past_last_of(
+            Iterator first, Iterator last, char_set const& set,
+            std::forward_iterator_tag)
+        {
+            Iterator result = first;
+            for (; first != last; ++first)
+            {
+                if (set.contains(*first))
+                    result = std::next(first);
+            }
+            return result;
+        }
+
+        template <typename Iterator>
+        Iterator find_past_last_of(
+            Iterator first, Iterator last, char_set const& set,
+            std::bidirectional_iterator_tag)
+        {
+            while (last != first)
+            {
+                Iterator const mark = last;
+                if (set.contains(*--last))
+                    return mark;
+            }
+            return first;
+        }
+
+        template <typename Iterator>
+        Iterator find_past_last_of(
+            Iterator first, Iterator last, char_set const& set)
+        {
+            return detail::find_past_last_of(first, last, set,
+                typename std::iterator_traits<Iterator>::iterator_category{});
+        }
+    }
+}}
+
+#endif /*EGGS_LEXER_CHAR_SET_HPP*/
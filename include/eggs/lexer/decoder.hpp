@@ -0,0 +1,468 @@
+//! \file eggs/lexer/decoder.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_DECODER_HPP
+#define EGGS_LEXER_DECODER_HPP
+
+#include <eggs/lexer/stream.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if !defined(EGGS_LEXER_NO_ZLIB) && __has_include(<zlib.h>)
+#  define EGGS_LEXER_HAS_ZLIB 1
+#  include <climits>
+#  include <zlib.h>
+#else
+#  define EGGS_LEXER_HAS_ZLIB 0
+#endif
+
+#if !defined(EGGS_LEXER_NO_ZSTD) && __has_include(<zstd.h>)
+#  define EGGS_LEXER_HAS_ZSTD 1
+#  include <zstd.h>
+#else
+#  define EGGS_LEXER_HAS_ZSTD 0
+#endif
+
+namespace eggs { namespace lexers
+{
+#if EGGS_LEXER_HAS_ZLIB
+    ///////////////////////////////////////////////////////////////////////////
+    //! class gzip_decoder;
+    //!
+    //! Class `gzip_decoder` represents an incremental decompression of a
+    //! gzip or zlib compressed input range. Concatenated gzip members are
+    //! decompressed as a single stream.
+    //!
+    //! \remarks Only available when zlib is; the program shall link against
+    //!  it.
+    class gzip_decoder
+    {
+        struct _deleter
+        {
+            void operator()(::z_stream* stream) const noexcept
+            {
+                ::inflateEnd(stream);
+                delete stream;
+            }
+        };
+
+    public:
+        //! gzip_decoder(char const* first, char const* last);
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Initializes the decoder to decompress `[first, last)`.
+        //!
+        //! \remarks The decoder refers to, but does not own, the compressed
+        //!  input range.
+        gzip_decoder(char const* first, char const* last)
+          : _stream()
+          , _next(first)
+          , _last(last)
+          , _end(false)
+        {
+            std::unique_ptr<::z_stream> stream(new ::z_stream());
+
+            // 15 window bits, plus 32 for automatic gzip/zlib detection
+            int const status = ::inflateInit2(stream.get(), 15 + 32);
+            if (status == Z_MEM_ERROR)
+                throw std::bad_alloc();
+            if (status != Z_OK)
+                throw std::runtime_error("gzip_decoder: inflateInit2 failed");
+            _stream.reset(stream.release());
+        }
+
+        //! char* decode(char* first, char* last);
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Decompresses into `[first, last)` until it is full or the
+        //!  compressed input is exhausted.
+        //!
+        //! \returns An iterator past the last decompressed character, which
+        //!  is `first` if and only if the end of the stream was reached.
+        //!
+        //! \throws `std::runtime_error` if the compressed input is corrupt or
+        //!  truncated.
+        char* decode(char* first, char* last)
+        {
+            ::z_stream& s = *_stream;
+            char* next = first;
+            while (next != last && !_end)
+            {
+                if (s.avail_in == 0 && _next != _last)
+                {
+                    std::size_t const size = (std::min)(
+                        static_cast<std::size_t>(_last - _next),
+                        static_cast<std::size_t>(UINT_MAX));
+                    s.next_in = reinterpret_cast<::Bytef*>(
+                        const_cast<char*>(_next));
+                    s.avail_in = static_cast<::uInt>(size);
+                    _next += size;
+                }
+
+                std::size_t const size = (std::min)(
+                    static_cast<std::size_t>(last - next),
+                    static_cast<std::size_t>(UINT_MAX));
+                s.next_out = reinterpret_cast<::Bytef*>(next);
+                s.avail_out = static_cast<::uInt>(size);
+
+                int const status = ::inflate(&s, Z_NO_FLUSH);
+                next += size - s.avail_out;
+
+                if (status == Z_STREAM_END)
+                {
+                    if (s.avail_in == 0 && _next == _last)
+                        _end = true;
+                    else
+                        ::inflateReset(&s);
+                } else if (status == Z_BUF_ERROR) {
+                    throw std::runtime_error(
+                        "gzip_decoder: unexpected end of input");
+                } else if (status == Z_MEM_ERROR) {
+                    throw std::bad_alloc();
+                } else if (status != Z_OK) {
+                    throw std::runtime_error(s.msg != nullptr
+                      ? s.msg : "gzip_decoder: corrupt input");
+                }
+            }
+            return next;
+        }
+
+    private:
+        std::unique_ptr<::z_stream, _deleter> _stream;
+        char const* _next;
+        char const* _last;
+        bool _end;
+    };
+#endif
+
+#if EGGS_LEXER_HAS_ZSTD
+    ///////////////////////////////////////////////////////////////////////////
+    //! class zstd_decoder;
+    //!
+    //! Class `zstd_decoder` represents an incremental decompression of a
+    //! zstd compressed input range. Concatenated frames are decompressed as
+    //! a single stream.
+    //!
+    //! \remarks Only available when libzstd is; the program shall link
+    //!  against it.
+    class zstd_decoder
+    {
+        struct _deleter
+        {
+            void operator()(::ZSTD_DStream* stream) const noexcept
+            {
+                ::ZSTD_freeDStream(stream);
+            }
+        };
+
+    public:
+        //! zstd_decoder(char const* first, char const* last);
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Initializes the decoder to decompress `[first, last)`.
+        //!
+        //! \remarks The decoder refers to, but does not own, the compressed
+        //!  input range.
+        zstd_decoder(char const* first, char const* last)
+          : _stream(::ZSTD_createDStream())
+          , _input{first, static_cast<std::size_t>(last - first), 0}
+          , _pending(1)
+        {
+            if (!_stream)
+                throw std::bad_alloc();
+            std::size_t const status = ::ZSTD_initDStream(_stream.get());
+            if (::ZSTD_isError(status))
+                throw std::runtime_error(::ZSTD_getErrorName(status));
+        }
+
+        //! char* decode(char* first, char* last);
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Decompresses into `[first, last)` until it is full or the
+        //!  compressed input is exhausted.
+        //!
+        //! \returns An iterator past the last decompressed character, which
+        //!  is `first` if and only if the end of the stream was reached.
+        //!
+        //! \throws `std::runtime_error` if the compressed input is corrupt or
+        //!  truncated.
+        char* decode(char* first, char* last)
+        {
+            ::ZSTD_outBuffer output{first, static_cast<std::size_t>(last - first), 0};
+            while (output.pos != output.size)
+            {
+                // the last frame is complete and flushed
+                if (_input.pos == _input.size && _pending == 0)
+                    break;
+
+                std::size_t const input_pos = _input.pos;
+                std::size_t const output_pos = output.pos;
+
+                std::size_t const pending = ::ZSTD_decompressStream(
+                    _stream.get(), &output, &_input);
+                if (::ZSTD_isError(pending))
+                    throw std::runtime_error(::ZSTD_getErrorName(pending));
+
+                if (_input.pos == input_pos && output.pos == output_pos)
+                    throw std::runtime_error(
+                        "zstd_decoder: unexpected end of input");
+                _pending = pending;
+            }
+            return first + output.pos;
+        }
+
+    private:
+        std::unique_ptr<::ZSTD_DStream, _deleter> _stream;
+        ::ZSTD_inBuffer _input;
+        std::size_t _pending;
+    };
+#endif
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Decoder>
+    //! class pipelined_decoder;
+    //!
+    //! Class template `pipelined_decoder` represents a decoding of an input
+    //! stream on a background thread, into a ring of buffers that are handed
+    //! over in order as chunks, so that decoding overlaps with processing
+    //! (e.g. lexing) of previously decoded chunks.
+    //!
+    //! \requires The type `Decoder` shall satisfy MoveConstructible. Given
+    //!  an lvalue `d` of type `Decoder` and `char* first, last` denoting a
+    //!  valid range, the expression `d.decode(first, last)` shall fill some
+    //!  part of `[first, last)` and return an iterator past it, or return
+    //!  `first` at the end of the stream.
+    template <typename Decoder>
+    class pipelined_decoder
+    {
+    public:
+        //! struct options;
+        //!
+        //! Class `options` holds the parameters of a `pipelined_decoder`.
+        struct options
+        {
+            //! std::size_t buffers = 4;
+            //!
+            //! The number of buffers in the ring.
+            std::size_t buffers = 4;
+
+            //! std::size_t buffer_size = 65536;
+            //!
+            //! The size of each buffer in the ring.
+            std::size_t buffer_size = 65536;
+        };
+
+    public:
+        //! explicit pipelined_decoder(Decoder decoder);
+        //!
+        //! \effects Equivalent to
+        //!  `pipelined_decoder(std::move(decoder), options())`.
+        explicit pipelined_decoder(Decoder decoder)
+          : pipelined_decoder(std::move(decoder), options())
+        {}
+
+        //! pipelined_decoder(Decoder decoder, options const& opts);
+        //!
+        //! \effects Initializes the ring of buffers according to `opts`, and
+        //!  starts decoding into it with `decoder` on a background thread.
+        pipelined_decoder(Decoder decoder, options const& opts)
+          : _decoder(std::move(decoder))
+          , _buffers((std::max)(opts.buffers, std::size_t(2)))
+          , _sizes(_buffers.size())
+          , _head(0)
+          , _count(0)
+          , _held(false)
+          , _done(false)
+          , _stop(false)
+        {
+            for (std::vector<char>& buffer : _buffers)
+                buffer.resize((std::max)(opts.buffer_size, std::size_t(1)));
+            _thread = std::thread(&pipelined_decoder::_produce, this);
+        }
+
+        pipelined_decoder(pipelined_decoder const&) = delete;
+        pipelined_decoder& operator=(pipelined_decoder const&) = delete;
+
+        //! ~pipelined_decoder();
+        //!
+        //! \effects Stops decoding, and waits for the background thread to
+        //!  finish.
+        ~pipelined_decoder()
+        {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _stop = true;
+            }
+            _freed.notify_one();
+            _thread.join();
+        }
+
+        //! std::pair<char const*, char const*> next();
+        //!
+        //! \effects Releases the previous chunk, if any, and waits for the
+        //!  next one to be decoded.
+        //!
+        //! \returns A range denoting the next chunk of decoded input, which
+        //!  is empty if and only if the end of the stream was reached. The
+        //!  range is valid until the next call to `next`.
+        //!
+        //! \throws Any exception thrown by the decoder.
+        std::pair<char const*, char const*> next()
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_held)
+            {
+                _head = (_head + 1) % _buffers.size();
+                --_count;
+                _held = false;
+                _freed.notify_one();
+            }
+
+            _filled.wait(lock, [&] { return _count != 0 || _done; });
+            if (_count == 0)
+            {
+                if (_error)
+                    std::rethrow_exception(_error);
+                return {nullptr, nullptr};
+            }
+
+            _held = true;
+            char const* const first = _buffers[_head].data();
+            return {first, first + _sizes[_head]};
+        }
+
+        //! template <class Lexer, class F>
+        //! stream_status for_each(chunked_lexer<Lexer, char>& lexer, F&& f);
+        //!
+        //! \requires The expression `f(t)` shall be valid, where `t` is an
+        //!  lvalue of type `typename chunked_lexer<Lexer, char>::token`.
+        //!
+        //! \effects Feeds each remaining chunk to `lexer`, then finishes it,
+        //!  and calls `f` on each of the demarcated tokens in order, until an
+        //!  invalid token is found or the input is exhausted.
+        //!
+        //! \returns `lexer.status()`.
+        //!
+        //! \remarks A token is valid only for the duration of the call to
+        //!  `f`.
+        template <typename Lexer, typename F>
+        stream_status for_each(chunked_lexer<Lexer, char>& lexer, F&& f)
+        {
+            std::vector<typename chunked_lexer<Lexer, char>::token> tokens;
+            for (;;)
+            {
+                std::pair<char const*, char const*> const chunk = next();
+                if (chunk.first == chunk.second)
+                    break;
+
+                tokens.clear();
+                lexer.feed(chunk.first, chunk.second, std::back_inserter(tokens));
+                for (auto& t : tokens)
+                    f(t);
+
+                if (lexer.status() == stream_status::error)
+                    return lexer.status();
+            }
+
+            tokens.clear();
+            lexer.finish(std::back_inserter(tokens));
+            for (auto& t : tokens)
+                f(t);
+            return lexer.status();
+        }
+
+    private:
+        void _produce() noexcept
+        {
+            std::size_t tail = 0;
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(_mutex);
+                    _freed.wait(lock, [&] {
+                        return _stop || _count != _buffers.size(); });
+                    if (_stop)
+                        return;
+                }
+
+                // the slot at `tail` is not visible to the consumer until
+                // it is published, so it is filled without the lock held
+                std::size_t size = 0;
+                std::exception_ptr error;
+                try
+                {
+                    char* const first = _buffers[tail].data();
+                    char* const last = first + _buffers[tail].size();
+                    char* next = first;
+                    while (next != last)
+                    {
+                        char* const end = _decoder.decode(next, last);
+                        if (end == next)
+                            break;
+                        next = end;
+                    }
+                    size = static_cast<std::size_t>(next - first);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                // a partially filled buffer marks the end of the stream
+                bool const done = error || size != _buffers[tail].size();
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    if (size != 0)
+                    {
+                        _sizes[tail] = size;
+                        ++_count;
+                        tail = (tail + 1) % _buffers.size();
+                    }
+                    if (done)
+                    {
+                        _error = error;
+                        _done = true;
+                    }
+                }
+                _filled.notify_one();
+                if (done)
+                    return;
+            }
+        }
+
+    private:
+        Decoder _decoder;
+        std::vector<std::vector<char>> _buffers;
+        std::vector<std::size_t> _sizes;
+        std::size_t _head;
+        std::size_t _count;
+        bool _held;
+        bool _done;
+        bool _stop;
+        std::exception_ptr _error;
+        std::mutex _mutex;
+        std::condition_variable _filled;
+        std::condition_variable _freed;
+        std::thread _thread;
+    };
+}}
+
+#endif /*EGGS_LEXER_DECODER_HPP*/
@@ -0,0 +1,651 @@
+//! \file eggs/lexer/file_reader.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_FILE_READER_HPP
+#define EGGS_LEXER_FILE_READER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#  define EGGS_LEXER_HAS_PREAD 1
+#  include <fcntl.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#else
+#  define EGGS_LEXER_HAS_PREAD 0
+#  include <cstdio>
+#endif
+
+#if EGGS_LEXER_HAS_PREAD && !defined(EGGS_LEXER_NO_IO_URING) \
+ && __has_include(<linux/io_uring.h>)
+#  define EGGS_LEXER_HAS_IO_URING 1
+#  include <linux/io_uring.h>
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#else
+#  define EGGS_LEXER_HAS_IO_URING 0
+#endif
+
+namespace eggs { namespace lexers
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        inline char const* c_str(char const* path) noexcept
+        {
+            return path;
+        }
+
+        template <typename Path>
+        auto c_str(Path const& path) noexcept
+         -> decltype(static_cast<char const*>(path.c_str()))
+        {
+            return path.c_str();
+        }
+
+#if EGGS_LEXER_HAS_PREAD
+        ///////////////////////////////////////////////////////////////////////
+        struct file_handle
+        {
+            int fd;
+            std::size_t size;
+
+            explicit file_handle(char const* path)
+              : fd(::open(path, O_RDONLY | O_CLOEXEC))
+              , size(0)
+            {
+                if (fd == -1)
+                    throw std::system_error(errno, std::generic_category(), path);
+
+                struct ::stat st;
+                if (::fstat(fd, &st) == -1)
+                {
+                    int const error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), path);
+                }
+                size = static_cast<std::size_t>(st.st_size);
+            }
+
+            file_handle(file_handle const&) = delete;
+            file_handle& operator=(file_handle const&) = delete;
+
+            ~file_handle()
+            {
+                if (fd != -1)
+                    ::close(fd);
+            }
+
+            int release() noexcept
+            {
+                return std::exchange(fd, -1);
+            }
+        };
+
+        inline std::size_t read_file(char const* path, std::vector<char>& buffer)
+        {
+            file_handle const file(path);
+            if (buffer.size() < file.size)
+                buffer.resize(file.size);
+
+            std::size_t size = 0;
+            while (size < file.size)
+            {
+                ::ssize_t const read = ::pread(file.fd,
+                    buffer.data() + size, file.size - size,
+                    static_cast<::off_t>(size));
+                if (read == -1 && errno == EINTR)
+                    continue;
+                if (read == -1)
+                    throw std::system_error(errno, std::generic_category(), path);
+                if (read == 0)
+                    break;
+                size += static_cast<std::size_t>(read);
+            }
+            return size;
+        }
+#else
+        ///////////////////////////////////////////////////////////////////////
+        inline std::size_t read_file(char const* path, std::vector<char>& buffer)
+        {
+            std::FILE* const file = std::fopen(path, "rb");
+            if (file == nullptr)
+                throw std::system_error(errno, std::generic_category(), path);
+
+            std::size_t size = 0;
+            for (;;)
+            {
+                if (size == buffer.size())
+                    buffer.resize(buffer.empty() ? 65536 : buffer.size() * 2);
+
+                std::size_t const read = std::fread(
+                    buffer.data() + size, 1, buffer.size() - size, file);
+                size += read;
+                if (read == 0)
+                    break;
+            }
+
+            bool const failed = std::ferror(file) != 0;
+            std::fclose(file);
+            if (failed)
+                throw std::system_error(EIO, std::generic_category(), path);
+            return size;
+        }
+#endif
+
+#if EGGS_LEXER_HAS_IO_URING
+        ///////////////////////////////////////////////////////////////////////
+        class io_uring
+        {
+        public:
+            explicit io_uring(unsigned entries) noexcept
+              : _fd(-1)
+            {
+                ::io_uring_params params{};
+                int const fd = static_cast<int>(
+                    ::syscall(__NR_io_uring_setup, entries, &params));
+                if (fd < 0)
+                    return;
+
+                _sq_length = params.sq_off.array
+                  + params.sq_entries * sizeof(unsigned);
+                _cq_length = params.cq_off.cqes
+                  + params.cq_entries * sizeof(::io_uring_cqe);
+                bool const single_mmap =
+                    (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+                if (single_mmap)
+                    _sq_length = _cq_length = (std::max)(_sq_length, _cq_length);
+
+                _sq_ring = ::mmap(nullptr, _sq_length,
+                    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd, IORING_OFF_SQ_RING);
+                _cq_ring = single_mmap ? _sq_ring : ::mmap(nullptr, _cq_length,
+                    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd, IORING_OFF_CQ_RING);
+                _sqes_length = params.sq_entries * sizeof(::io_uring_sqe);
+                void* const sqes = ::mmap(nullptr, _sqes_length,
+                    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd, IORING_OFF_SQES);
+                if (_sq_ring == MAP_FAILED || _cq_ring == MAP_FAILED
+                 || sqes == MAP_FAILED)
+                {
+                    if (_sq_ring != MAP_FAILED)
+                        ::munmap(_sq_ring, _sq_length);
+                    if (!single_mmap && _cq_ring != MAP_FAILED)
+                        ::munmap(_cq_ring, _cq_length);
+                    if (sqes != MAP_FAILED)
+                        ::munmap(sqes, _sqes_length);
+                    ::close(fd);
+                    return;
+                }
+
+                char* const sq = static_cast<char*>(_sq_ring);
+                _sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+                _sq_mask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+                _sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+                _sqes = static_cast<::io_uring_sqe*>(sqes);
+
+                char* const cq = static_cast<char*>(_cq_ring);
+                _cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+                _cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+                _cq_mask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+                _cqes = reinterpret_cast<::io_uring_cqe*>(cq + params.cq_off.cqes);
+
+                _fd = fd;
+                _pending = 0;
+            }
+
+            io_uring(io_uring const&) = delete;
+            io_uring& operator=(io_uring const&) = delete;
+
+            ~io_uring()
+            {
+                if (_fd == -1)
+                    return;
+
+                ::munmap(_sqes, _sqes_length);
+                if (_cq_ring != _sq_ring)
+                    ::munmap(_cq_ring, _cq_length);
+                ::munmap(_sq_ring, _sq_length);
+                ::close(_fd);
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return _fd != -1;
+            }
+
+            void readv(int fd, ::iovec const* iov, ::off_t offset,
+                std::uint64_t user_data) noexcept
+            {
+                unsigned const tail = *_sq_tail;
+                unsigned const index = tail & _sq_mask;
+
+                ::io_uring_sqe& sqe = _sqes[index];
+                sqe = ::io_uring_sqe{};
+                sqe.opcode = IORING_OP_READV;
+                sqe.fd = fd;
+                sqe.addr = reinterpret_cast<std::uint64_t>(iov);
+                sqe.len = 1;
+                sqe.off = static_cast<std::uint64_t>(offset);
+                sqe.user_data = user_data;
+
+                _sq_array[index] = index;
+                __atomic_store_n(_sq_tail, tail + 1, __ATOMIC_RELEASE);
+                ++_pending;
+            }
+
+            template <typename F>
+            void wait(F&& f)
+            {
+                for (;;)
+                {
+                    int const result = static_cast<int>(::syscall(
+                        __NR_io_uring_enter, _fd, _pending, 1u,
+                        IORING_ENTER_GETEVENTS, nullptr, 0));
+                    if (result >= 0)
+                    {
+                        _pending -= (std::min)(
+                            static_cast<unsigned>(result), _pending);
+                        break;
+                    }
+                    if (errno != EINTR)
+                        throw std::system_error(errno, std::generic_category(),
+                            "io_uring_enter");
+                }
+
+                unsigned head = *_cq_head;
+                unsigned const tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+                for (; head != tail; ++head)
+                {
+                    ::io_uring_cqe const cqe = _cqes[head & _cq_mask];
+                    __atomic_store_n(_cq_head, head + 1, __ATOMIC_RELEASE);
+                    f(cqe.user_data, cqe.res);
+                }
+            }
+
+        private:
+            int _fd;
+            unsigned _pending;
+
+            void* _sq_ring;
+            std::size_t _sq_length;
+            unsigned* _sq_tail;
+            unsigned _sq_mask;
+            unsigned* _sq_array;
+            ::io_uring_sqe* _sqes;
+            std::size_t _sqes_length;
+
+            void* _cq_ring;
+            std::size_t _cq_length;
+            unsigned* _cq_head;
+            unsigned* _cq_tail;
+            unsigned _cq_mask;
+            ::io_uring_cqe* _cqes;
+        };
+#endif
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! class file_reader;
+    //!
+    //! Class `file_reader` represents a pipelined reader of whole files, which
+    //! keeps a number of reads in flight into a pool of reusable buffers and
+    //! hands each file contents over as soon as its read completes, so that
+    //! I/O overlaps with processing (e.g. lexing) of previously read files.
+    //!
+    //! \remarks Reads are issued through `io_uring` where available, and
+    //!  otherwise by a pool of reader threads. On platforms without `pread`,
+    //!  those threads read through `std::fread` instead.
+    class file_reader
+    {
+    public:
+        //! struct options;
+        //!
+        //! Class `options` holds the parameters of a `file_reader`.
+        struct options
+        {
+            //! std::size_t depth = 8;
+            //!
+            //! The maximum number of files read concurrently, which is also
+            //! the number of buffers in the pool.
+            std::size_t depth = 8;
+
+            //! bool io_uring = true;
+            //!
+            //! Whether to use `io_uring`, if available.
+            bool io_uring = true;
+        };
+
+    public:
+        //! file_reader();
+        //!
+        //! \effects Equivalent to `file_reader(options())`.
+        file_reader()
+          : file_reader(options())
+        {}
+
+        //! explicit file_reader(options const& opts);
+        //!
+        //! \effects Initializes the reader according to `opts`.
+        explicit file_reader(options const& opts)
+          : _depth(opts.depth != 0 ? opts.depth : 1)
+          , _buffers(_depth)
+#if EGGS_LEXER_HAS_IO_URING
+          , _ring(opts.io_uring
+              ? new detail::io_uring(static_cast<unsigned>(_depth)) : nullptr)
+#endif
+        {
+#if EGGS_LEXER_HAS_IO_URING
+            if (_ring != nullptr && !*_ring)
+            {
+                delete _ring;
+                _ring = nullptr;
+            }
+#endif
+        }
+
+        file_reader(file_reader const&) = delete;
+        file_reader& operator=(file_reader const&) = delete;
+
+        ~file_reader()
+        {
+#if EGGS_LEXER_HAS_IO_URING
+            delete _ring;
+#endif
+        }
+
+        //! bool uses_io_uring() const noexcept;
+        //!
+        //! \returns `true` if reads are issued through `io_uring`; otherwise,
+        //!  `false`.
+        bool uses_io_uring() const noexcept
+        {
+#if EGGS_LEXER_HAS_IO_URING
+            return _ring != nullptr;
+#else
+            return false;
+#endif
+        }
+
+        //! template <class ForwardIterator, class F>
+        //! void read(ForwardIterator first, ForwardIterator last, F&& f);
+        //!
+        //! \requires The type `ForwardIterator` shall satisfy
+        //!  ForwardIterator. Each element in `[first, last)` shall either be
+        //!  convertible to `char const*` or have a member function `c_str()`
+        //!  returning `char const*`, denoting a file path. The expression
+        //!  `f(i, data, data + size)` shall be valid, where `i` is a
+        //!  `std::size_t` and `data` is a `char const*`.
+        //!
+        //! \effects Reads the contents of each file in `[first, last)`, and
+        //!  calls `f` on the calling thread with the 0-based index of the file
+        //!  and the range denoting its contents, in the order in which the
+        //!  reads complete. The range is valid only for the duration of the
+        //!  call to `f`.
+        //!
+        //! \throws `std::system_error` if a file cannot be opened or read,
+        //!  after all reads in flight are completed. Any exception thrown by
+        //!  `f` is propagated likewise.
+        template <typename ForwardIterator, typename F>
+        void read(ForwardIterator first, ForwardIterator last, F&& f)
+        {
+            std::vector<char const*> paths;
+            for (; first != last; ++first)
+                paths.push_back(detail::c_str(*first));
+
+#if EGGS_LEXER_HAS_IO_URING
+            if (_ring != nullptr)
+                return _read_io_uring(paths, f);
+#endif
+            return _read_threads(paths, f);
+        }
+
+    private:
+#if EGGS_LEXER_HAS_IO_URING
+        template <typename F>
+        void _read_io_uring(std::vector<char const*> const& paths, F& f)
+        {
+            struct slot
+            {
+                std::size_t index;
+                int fd;
+                std::size_t size;
+                std::size_t read;
+                ::iovec iov;
+            };
+            std::vector<slot> slots(_depth, slot{0, -1, 0, 0, {}});
+            std::vector<std::size_t> free;
+            for (std::size_t i = _depth; i != 0; --i)
+                free.push_back(i - 1);
+
+            std::exception_ptr error;
+            auto finish = [&](slot& s) noexcept
+            {
+                ::close(s.fd);
+                s.fd = -1;
+                std::size_t const index = &s - slots.data();
+                free.push_back(index);
+            };
+            auto submit_rest = [&](slot& s) noexcept
+            {
+                s.iov.iov_base = _buffers[&s - slots.data()].data() + s.read;
+                s.iov.iov_len = s.size - s.read;
+                _ring->readv(s.fd, &s.iov, static_cast<::off_t>(s.read),
+                    static_cast<std::uint64_t>(&s - slots.data()));
+            };
+
+            std::size_t next = 0;
+            while (free.size() != _depth || (next < paths.size() && !error))
+            {
+                while (!free.empty() && next < paths.size() && !error)
+                {
+                    std::size_t const index = next++;
+                    std::size_t const s_index = free.back();
+                    slot& s = slots[s_index];
+                    try
+                    {
+                        detail::file_handle file(paths[index]);
+                        std::vector<char>& buffer = _buffers[s_index];
+                        if (buffer.size() < file.size)
+                            buffer.resize(file.size);
+
+                        s = slot{index, file.release(), file.size, 0, {}};
+                    } catch (...) {
+                        error = std::current_exception();
+                        break;
+                    }
+                    free.pop_back();
+
+                    if (s.size == 0)
+                    {
+                        if (!error)
+                            error = _deliver(
+                                f, s.index, _buffers[s_index].data(), 0);
+                        finish(s);
+                        continue;
+                    }
+                    submit_rest(s);
+                }
+                if (free.size() == _depth)
+                    continue;
+
+                _ring->wait([&](std::uint64_t user_data, int result)
+                {
+                    slot& s = slots[static_cast<std::size_t>(user_data)];
+                    if (result < 0 || (result == 0 && s.read < s.size))
+                    {
+                        if (!error)
+                        {
+                            error = std::make_exception_ptr(std::system_error(
+                                result < 0 ? -result : EIO,
+                                std::generic_category(), paths[s.index]));
+                        }
+                        finish(s);
+                        return;
+                    }
+
+                    s.read += static_cast<std::size_t>(result);
+                    if (s.read < s.size)
+                        return submit_rest(s);
+
+                    if (!error)
+                        error = _deliver(f, s.index,
+                            _buffers[&s - slots.data()].data(), s.size);
+                    finish(s);
+                });
+            }
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+#endif
+
+        template <typename F>
+        void _read_threads(std::vector<char const*> const& paths, F& f)
+        {
+            struct completion
+            {
+                std::size_t index;
+                std::size_t buffer;
+                std::size_t size;
+            };
+
+            std::mutex mutex;
+            std::condition_variable ready_cv;
+            std::condition_variable free_cv;
+            std::deque<completion> ready;
+            std::vector<std::size_t> free;
+            for (std::size_t i = _depth; i != 0; --i)
+                free.push_back(i - 1);
+            std::size_t next = 0;
+            std::size_t pending = paths.size();
+            bool stop = false;
+            std::exception_ptr error;
+
+            auto worker = [&]()
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                for (;;)
+                {
+                    free_cv.wait(lock, [&] { return stop || !free.empty(); });
+                    if (stop || next == paths.size())
+                        return;
+
+                    std::size_t const index = next++;
+                    std::size_t const buffer = free.back();
+                    free.pop_back();
+
+                    lock.unlock();
+                    std::size_t size = 0;
+                    std::exception_ptr read_error;
+                    try
+                    {
+                        size = detail::read_file(paths[index], _buffers[buffer]);
+                    } catch (...) {
+                        read_error = std::current_exception();
+                    }
+                    lock.lock();
+
+                    if (read_error)
+                    {
+                        if (!error)
+                            error = read_error;
+                        stop = true;
+                        free.push_back(buffer);
+                        free_cv.notify_all();
+                        ready_cv.notify_one();
+                        return;
+                    }
+                    ready.push_back(completion{index, buffer, size});
+                    ready_cv.notify_one();
+                }
+            };
+
+            std::vector<std::thread> workers;
+            std::size_t const threads = (std::min)(_depth, paths.size());
+            for (std::size_t i = 0; i < threads; ++i)
+                workers.emplace_back(worker);
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (pending != 0)
+                {
+                    ready_cv.wait(lock, [&] { return stop || !ready.empty(); });
+                    if (ready.empty())
+                        break;
+
+                    completion const c = ready.front();
+                    ready.pop_front();
+                    --pending;
+                    bool const failed = static_cast<bool>(error);
+
+                    lock.unlock();
+                    std::exception_ptr deliver_error;
+                    if (!failed)
+                    {
+                        deliver_error = _deliver(
+                            f, c.index, _buffers[c.buffer].data(), c.size);
+                    }
+                    lock.lock();
+
+                    if (deliver_error && !error)
+                        error = deliver_error;
+                    if (error)
+                        stop = true;
+                    free.push_back(c.buffer);
+                    free_cv.notify_all();
+                }
+                stop = true;
+                free_cv.notify_all();
+            }
+
+            for (std::thread& t : workers)
+                t.join();
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        template <typename F>
+        static std::exception_ptr _deliver(
+            F& f, std::size_t index, char const* data, std::size_t size) noexcept
+        {
+            try
+            {
+                f(index, data, data + size);
+            } catch (...) {
+                return std::current_exception();
+            }
+            return nullptr;
+        }
+
+    private:
+        std::size_t _depth;
+        std::vector<std::vector<char>> _buffers;
+#if EGGS_LEXER_HAS_IO_URING
+        detail::io_uring* _ring;
+#endif
+    };
+}}
+
+#endif /*EGGS_LEXER_FILE_READER_HPP*/
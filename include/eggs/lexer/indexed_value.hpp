@@ -0,0 +1,204 @@
+//! \file eggs/lexer/indexed_value.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_INDEXED_VALUE_HPP
+#define EGGS_LEXER_INDEXED_VALUE_HPP
+
+#include <eggs/lexer/token.hpp>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace eggs { namespace lexers
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <typename ...Ts>
+        union indexed_storage
+        {};
+
+        template <typename T, typename ...Ts>
+        union indexed_storage<T, Ts...>
+        {
+            T head;
+            indexed_storage<Ts...> tail;
+
+            constexpr indexed_storage() noexcept
+              : tail()
+            {}
+        };
+
+        template <std::size_t I, typename T, typename ...Ts>
+        constexpr auto* indexed_get(indexed_storage<T, Ts...>* storage) noexcept
+        {
+            if constexpr (I == 0)
+                return &storage->head;
+            else
+                return detail::indexed_get<I - 1>(&storage->tail);
+        }
+
+        template <std::size_t I, typename T, typename ...Ts>
+        constexpr auto const* indexed_get(
+            indexed_storage<T, Ts...> const* storage) noexcept
+        {
+            if constexpr (I == 0)
+                return &storage->head;
+            else
+                return detail::indexed_get<I - 1>(&storage->tail);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename T>
+        struct indexed_alternative
+        {
+            using type = T;
+        };
+
+        template <>
+        struct indexed_alternative<void>
+        {
+            using type = std::monostate;
+        };
+
+        template <typename T>
+        using indexed_alternative_t = typename indexed_alternative<T>::type;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class ...Vs>
+    //! class indexed_value;
+    //!
+    //! Class template `indexed_value` represents the associated value of a
+    //! token as an untagged union with one member per category, where `Vs`
+    //! is the type of the associated value of each category in order. Unlike
+    //! `std::variant`, it keeps no discriminator of its own: the active
+    //! member is the one corresponding to the category of the token that
+    //! holds it, if any.
+    //!
+    //! \requires Each type in the parameter pack `Vs` shall be trivially
+    //!  copyable.
+    //!
+    //! \remarks The members of `indexed_value` are accessed through the
+    //!  token that holds it, by `get_value` and `get_value_if`.
+    template <typename ...Vs>
+    class indexed_value
+    {
+        static_assert(sizeof...(Vs) > 0);
+        static_assert(std::conjunction_v<std::is_trivially_copyable<Vs>...>,
+            "indexed_value alternatives shall be trivially copyable");
+
+    public:
+        //! constexpr indexed_value() noexcept;
+        //!
+        //! \effects Initializes no member.
+        constexpr indexed_value() noexcept
+          : _storage()
+        {}
+
+        //! template <std::size_t I, class ...Args>
+        //! explicit indexed_value(std::in_place_index_t<I>, Args&&... args);
+        //!
+        //! \effects Initializes the `I`th member from the given arguments.
+        template <std::size_t I, typename ...Args>
+        explicit indexed_value(std::in_place_index_t<I>, Args&&... args)
+          : _storage()
+        {
+            using type = std::remove_pointer_t<decltype(
+                detail::indexed_get<I>(&_storage))>;
+            ::new (static_cast<void*>(detail::indexed_get<I>(&_storage)))
+                type(std::forward<Args>(args)...);
+        }
+
+    private:
+        template <std::size_t I, typename Iterator, typename ...Ws>
+        friend constexpr auto* get_value_if(
+            token<Iterator, indexed_value<Ws...>>* token) noexcept;
+
+        template <std::size_t I, typename Iterator, typename ...Ws>
+        friend constexpr auto const* get_value_if(
+            token<Iterator, indexed_value<Ws...>> const* token) noexcept;
+
+        detail::indexed_storage<Vs...> _storage;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <std::size_t I, class Iterator, class ...Vs>
+    //! constexpr see-below* get_value_if(token<Iterator, indexed_value<Vs...>>* token) noexcept;
+    //!
+    //! \requires `I < sizeof...(Vs)`.
+    //!
+    //! \returns A pointer to the `I`th member of the associated value of
+    //!  `*token`, if `token` is not null and its category is `I`;
+    //!  otherwise, a null pointer.
+    template <std::size_t I, typename Iterator, typename ...Vs>
+    constexpr auto* get_value_if(
+        token<Iterator, indexed_value<Vs...>>* token) noexcept
+    {
+        static_assert(I < sizeof...(Vs));
+        using type = std::remove_pointer_t<decltype(
+            detail::indexed_get<I>(&token->value._storage))>;
+        return token != nullptr && token->category() == I
+          ? std::launder(detail::indexed_get<I>(&token->value._storage))
+          : static_cast<type*>(nullptr);
+    }
+
+    //! template <std::size_t I, class Iterator, class ...Vs>
+    //! constexpr see-below const* get_value_if(token<Iterator, indexed_value<Vs...>> const* token) noexcept;
+    //!
+    //! \effects Equivalent to the non-const overload.
+    template <std::size_t I, typename Iterator, typename ...Vs>
+    constexpr auto const* get_value_if(
+        token<Iterator, indexed_value<Vs...>> const* token) noexcept
+    {
+        static_assert(I < sizeof...(Vs));
+        using type = std::remove_pointer_t<decltype(
+            detail::indexed_get<I>(&token->value._storage))>;
+        return token != nullptr && token->category() == I
+          ? std::launder(detail::indexed_get<I>(&token->value._storage))
+          : static_cast<type*>(nullptr);
+    }
+
+    //! template <std::size_t I, class Iterator, class ...Vs>
+    //! constexpr see-below& get_value(token<Iterator, indexed_value<Vs...>>& token);
+    //!
+    //! \requires `I < sizeof...(Vs)`.
+    //!
+    //! \returns A reference to the `I`th member of the associated value of
+    //!  `token`.
+    //!
+    //! \throws `std::bad_variant_access` if the category of `token` is not
+    //!  `I`.
+    template <std::size_t I, typename Iterator, typename ...Vs>
+    constexpr auto& get_value(token<Iterator, indexed_value<Vs...>>& token)
+    {
+        auto* const value = lexers::get_value_if<I>(&token);
+        if (value == nullptr)
+            throw std::bad_variant_access();
+        return *value;
+    }
+
+    //! template <std::size_t I, class Iterator, class ...Vs>
+    //! constexpr see-below const& get_value(token<Iterator, indexed_value<Vs...>> const& token);
+    //!
+    //! \effects Equivalent to the non-const overload.
+    template <std::size_t I, typename Iterator, typename ...Vs>
+    constexpr auto const& get_value(
+        token<Iterator, indexed_value<Vs...>> const& token)
+    {
+        auto const* const value = lexers::get_value_if<I>(&token);
+        if (value == nullptr)
+            throw std::bad_variant_access();
+        return *value;
+    }
+}}
+
+#endif /*EGGS_LEXER_INDEXED_VALUE_HPP*/
@@ -0,0 +1,488 @@
+//! \file eggs/lexer/intern.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_INTERN_HPP
+#define EGGS_LEXER_INTERN_HPP
+
+#include <eggs/lexer/token.hpp>
+#include <eggs/lexer/tokenize.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace eggs { namespace lexers
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // 64-bit FNV-1a
+        constexpr std::uint64_t fnv1a_basis = 14695981039346656037ull;
+        constexpr std::uint64_t fnv1a_prime = 1099511628211ull;
+
+        constexpr std::uint64_t fnv1a(
+            std::uint64_t hash, unsigned char c) noexcept
+        {
+            return (hash ^ c) * fnv1a_prime;
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        class intern_shard
+        {
+            struct _key
+            {
+                std::string_view text;
+                std::uint64_t hash;
+
+                friend bool operator==(_key const& lhs, _key const& rhs) noexcept
+                {
+                    return lhs.text == rhs.text;
+                }
+            };
+
+            struct _key_hash
+            {
+                std::size_t operator()(_key const& key) const noexcept
+                {
+                    return static_cast<std::size_t>(key.hash);
+                }
+            };
+
+        public:
+            // returns the local index of `text`, inserting it if needed
+            std::size_t intern(std::string_view text, std::uint64_t hash)
+            {
+                auto const iter = _indices.find(_key{text, hash});
+                if (iter != _indices.end())
+                    return iter->second;
+
+                std::string const& name = _names.emplace_back(text);
+                try
+                {
+                    _indices.emplace(_key{name, hash}, _names.size() - 1);
+                } catch (...) {
+                    _names.pop_back();
+                    throw;
+                }
+                return _names.size() - 1;
+            }
+
+            std::string_view name(std::size_t index) const noexcept
+            {
+                return _names[index];
+            }
+
+            std::size_t size() const noexcept
+            {
+                return _names.size();
+            }
+
+        private:
+            std::unordered_map<_key, std::size_t, _key_hash> _indices;
+            std::deque<std::string> _names;
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! struct symbol;
+    //!
+    //! Class `symbol` represents the identifier of a string interned in an
+    //! `intern_table` or a `concurrent_intern_table`.
+    struct symbol
+    {
+        //! std::uint32_t id;
+        std::uint32_t id;
+
+        //! friend constexpr bool operator==(symbol lhs, symbol rhs) noexcept;
+        friend constexpr bool operator==(symbol lhs, symbol rhs) noexcept
+        {
+            return lhs.id == rhs.id;
+        }
+
+        //! friend constexpr bool operator!=(symbol lhs, symbol rhs) noexcept;
+        friend constexpr bool operator!=(symbol lhs, symbol rhs) noexcept
+        {
+            return lhs.id != rhs.id;
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Iterator>
+    //! class hashing_iterator;
+    //!
+    //! Class template `hashing_iterator` represents a ForwardIterator adaptor
+    //! that folds each character it steps over into a 64-bit FNV-1a hash, so
+    //! that an iterator obtained by incrementing another one carries the hash
+    //! of the characters in between.
+    //!
+    //! \requires The type `Iterator` shall satisfy ForwardIterator, and its
+    //!  value type shall be a character type.
+    template <typename Iterator>
+    class hashing_iterator
+    {
+        using _traits = std::iterator_traits<Iterator>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename _traits::value_type;
+        using difference_type = typename _traits::difference_type;
+        using pointer = typename _traits::pointer;
+        using reference = typename _traits::reference;
+
+    public:
+        //! hashing_iterator();
+        //!
+        //! \effects Value-initializes the underlying iterator, and
+        //!  initializes the hash to that of an empty string.
+        hashing_iterator()
+          : _base()
+          , _hash(detail::fnv1a_basis)
+        {}
+
+        //! explicit hashing_iterator(Iterator base);
+        //!
+        //! \effects Initializes the underlying iterator with `base`, and the
+        //!  hash to that of an empty string.
+        explicit hashing_iterator(Iterator base)
+          : _base(base)
+          , _hash(detail::fnv1a_basis)
+        {}
+
+        //! Iterator base() const;
+        //!
+        //! \returns The underlying iterator.
+        Iterator base() const
+        {
+            return _base;
+        }
+
+        //! std::uint64_t hash() const noexcept;
+        //!
+        //! \returns The hash of the characters stepped over since
+        //!  construction.
+        std::uint64_t hash() const noexcept
+        {
+            return _hash;
+        }
+
+        reference operator*() const
+        {
+            return *_base;
+        }
+
+        hashing_iterator& operator++()
+        {
+            _hash = detail::fnv1a(_hash, static_cast<unsigned char>(*_base));
+            ++_base;
+            return *this;
+        }
+
+        hashing_iterator operator++(int)
+        {
+            hashing_iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(
+            hashing_iterator const& lhs, hashing_iterator const& rhs)
+        {
+            return lhs._base == rhs._base;
+        }
+
+        friend bool operator!=(
+            hashing_iterator const& lhs, hashing_iterator const& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        Iterator _base;
+        std::uint64_t _hash;
+    };
+
+    //! template <class Sentinel>
+    //! struct hashing_sentinel;
+    //!
+    //! Class template `hashing_sentinel` represents the end of the range of
+    //! a `hashing_iterator`. It is a distinct type even when `Sentinel` is
+    //! the underlying iterator type, since it carries no hash of its own.
+    template <typename Sentinel>
+    struct hashing_sentinel
+    {
+        Sentinel base;
+
+        template <typename Iterator>
+        friend bool operator==(
+            hashing_iterator<Iterator> const& lhs, hashing_sentinel const& rhs)
+        {
+            return lhs.base() == rhs.base;
+        }
+
+        template <typename Iterator>
+        friend bool operator!=(
+            hashing_iterator<Iterator> const& lhs, hashing_sentinel const& rhs)
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! class intern_table;
+    //!
+    //! Class `intern_table` represents a set of interned strings, each
+    //! identified by a `symbol` whose ids are dense, in order of insertion.
+    //!
+    //! \remarks An `intern_table` is not safe to use concurrently.
+    class intern_table
+    {
+    public:
+        //! static constexpr std::uint64_t hash(std::string_view text) noexcept;
+        //!
+        //! \returns The hash of `text`, as computed by `hashing_iterator`.
+        static constexpr std::uint64_t hash(std::string_view text) noexcept
+        {
+            std::uint64_t hash = detail::fnv1a_basis;
+            for (char c : text)
+                hash = detail::fnv1a(hash, static_cast<unsigned char>(c));
+            return hash;
+        }
+
+        //! symbol intern(std::string_view text, std::uint64_t hash);
+        //!
+        //! \preconditions `hash == intern_table::hash(text)`.
+        //!
+        //! \effects Inserts a copy of `text` into the table, unless it is
+        //!  already there.
+        //!
+        //! \returns The symbol that identifies `text`.
+        //!
+        //! \throws `std::length_error` if the table already holds `2^32`
+        //!  strings.
+        symbol intern(std::string_view text, std::uint64_t hash)
+        {
+            std::size_t const index = _shard.intern(text, hash);
+            if (index > std::numeric_limits<std::uint32_t>::max())
+                throw std::length_error("intern_table is full");
+            return symbol{std::uint32_t(index)};
+        }
+
+        //! symbol intern(std::string_view text);
+        //!
+        //! \effects Equivalent to `return intern(text, hash(text));`.
+        symbol intern(std::string_view text)
+        {
+            return intern(text, hash(text));
+        }
+
+        //! std::string_view name(symbol sym) const noexcept;
+        //!
+        //! \preconditions `sym` was returned by `intern` on `*this`.
+        //!
+        //! \returns The interned string identified by `sym`, which remains
+        //!  valid for the lifetime of the table.
+        std::string_view name(symbol sym) const noexcept
+        {
+            return _shard.name(sym.id);
+        }
+
+        //! std::size_t size() const noexcept;
+        //!
+        //! \returns The number of interned strings.
+        std::size_t size() const noexcept
+        {
+            return _shard.size();
+        }
+
+    private:
+        detail::intern_shard _shard;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! class concurrent_intern_table;
+    //!
+    //! Class `concurrent_intern_table` represents a set of interned strings
+    //! that is safe to use concurrently. Strings are spread by hash over a
+    //! number of independently locked shards, so that threads interning
+    //! different strings rarely contend.
+    //!
+    //! \remarks Symbol ids are unique but not dense.
+    class concurrent_intern_table
+    {
+        static constexpr unsigned _shard_bits = 6;
+        static constexpr std::size_t _shards = std::size_t(1) << _shard_bits;
+
+    public:
+        //! static constexpr std::uint64_t hash(std::string_view text) noexcept;
+        //!
+        //! \returns `intern_table::hash(text)`.
+        static constexpr std::uint64_t hash(std::string_view text) noexcept
+        {
+            return intern_table::hash(text);
+        }
+
+        //! symbol intern(std::string_view text, std::uint64_t hash);
+        //!
+        //! \preconditions `hash == concurrent_intern_table::hash(text)`.
+        //!
+        //! \effects Inserts a copy of `text` into the table, unless it is
+        //!  already there.
+        //!
+        //! \returns The symbol that identifies `text`.
+        //!
+        //! \throws `std::length_error` if the shard for `text` already holds
+        //!  `2^26` strings.
+        symbol intern(std::string_view text, std::uint64_t hash)
+        {
+            std::size_t const shard = std::size_t(hash >> (64 - _shard_bits));
+            _shard& s = _shards_storage[shard];
+
+            std::size_t index;
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                index = s.strings.intern(text, hash);
+            }
+            if (index > (std::numeric_limits<std::uint32_t>::max() >> _shard_bits))
+                throw std::length_error("concurrent_intern_table is full");
+            return symbol{std::uint32_t(index << _shard_bits | shard)};
+        }
+
+        //! symbol intern(std::string_view text);
+        //!
+        //! \effects Equivalent to `return intern(text, hash(text));`.
+        symbol intern(std::string_view text)
+        {
+            return intern(text, hash(text));
+        }
+
+        //! std::string_view name(symbol sym) const;
+        //!
+        //! \preconditions `sym` was returned by `intern` on `*this`.
+        //!
+        //! \returns The interned string identified by `sym`, which remains
+        //!  valid for the lifetime of the table.
+        std::string_view name(symbol sym) const
+        {
+            _shard const& s = _shards_storage[sym.id & (_shards - 1)];
+            std::lock_guard<std::mutex> lock(s.mutex);
+            return s.strings.name(sym.id >> _shard_bits);
+        }
+
+        //! std::size_t size() const;
+        //!
+        //! \returns The number of interned strings.
+        std::size_t size() const
+        {
+            std::size_t size = 0;
+            for (_shard const& s : _shards_storage)
+            {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                size += s.strings.size();
+            }
+            return size;
+        }
+
+    private:
+        struct alignas(64) _shard
+        {
+            mutable std::mutex mutex;
+            detail::intern_shard strings;
+        };
+
+        std::array<_shard, _shards> _shards_storage;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Rule, class Table = intern_table>
+    //! class interning_rule;
+    //!
+    //! Class template `interning_rule` represents a tokenization rule adaptor
+    //! that demarcates tokens as `Rule` does, and whose associated value is
+    //! the `symbol` of the lexeme interned into a table. The hash of the
+    //! lexeme is computed by `Rule` itself as it scans the input, through a
+    //! `hashing_iterator`, so that interning does not read it again unless
+    //! it is new to the table.
+    //!
+    //! \requires `Rule` shall satisfy TokenizationRule; the associated value
+    //!  it produces (if any) is discarded. `Table` shall be either
+    //!  `intern_table`, or `concurrent_intern_table` when tokens are
+    //!  evaluated concurrently (e.g. by `parallel_lex_into`).
+    //!
+    //! \remarks Every token evaluated is interned, including those that are
+    //!  later discarded; `parallel_lex` may thus pollute the table with
+    //!  lexemes from speculative starts, whereas `parallel_lex_into` only
+    //!  evaluates tokens at true token boundaries.
+    template <typename Rule, typename Table = intern_table>
+    class interning_rule
+    {
+    public:
+        //! explicit interning_rule(Table& table, Rule rule = Rule());
+        //!
+        //! \effects Initializes the adapted rule with `std::move(rule)`, and
+        //!  refers to `table` for interning lexemes.
+        explicit interning_rule(Table& table, Rule rule = Rule())
+          : _table(&table)
+          , _rule(std::move(rule))
+        {}
+
+        //! template <class Iterator, class Sentinel>
+        //! std::pair<Iterator, std::uint64_t> operator()(Iterator first, Sentinel last) const;
+        //!
+        //! \returns A pair of the mark demarcated by `rule(first, last)`,
+        //!  and the hash of the characters in `[first, mark)`.
+        //!
+        //! \remarks `rule` is given a `hashing_iterator` and a
+        //!  `hashing_sentinel`; it shall return a mark obtained by
+        //!  incrementing the former, rather than the latter.
+        template <typename Iterator, typename Sentinel>
+        std::pair<Iterator, std::uint64_t> operator()(
+            Iterator first, Sentinel last) const
+        {
+            auto&& result = _rule(
+                hashing_iterator<Iterator>(first), hashing_sentinel<Sentinel>{last});
+            hashing_iterator<Iterator> const mark =
+                detail::get_mark<hashing_iterator<Iterator>>(result);
+            return std::make_pair(mark.base(), mark.hash());
+        }
+
+        //! template <class Iterator>
+        //! symbol evaluate(token<Iterator, std::uint64_t>&& token) const;
+        //!
+        //! \returns The symbol of the lexeme of `token` in the table.
+        template <typename Iterator>
+        symbol evaluate(token<Iterator, std::uint64_t>&& token) const
+        {
+            if constexpr (std::is_pointer_v<Iterator>)
+            {
+                return _table->intern(
+                    std::string_view(token.first,
+                        std::size_t(token.second - token.first)),
+                    token.value);
+            } else {
+                std::string const text(token.first, token.second);
+                return _table->intern(text, token.value);
+            }
+        }
+
+    private:
+        Table* _table;
+        Rule _rule;
+    };
+}}
+
+#endif /*EGGS_LEXER_INTERN_HPP*/
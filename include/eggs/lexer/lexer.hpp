@@ -9,14 +9,28 @@
 #ifndef EGGS_LEXER_LEXER_HPP
 #define EGGS_LEXER_LEXER_HPP
 
+#include <eggs/lexer/char_set.hpp>
+#include <eggs/lexer/indexed_value.hpp>
+#include <eggs/lexer/packed_token.hpp>
+#include <eggs/lexer/parallel.hpp>
+#include <eggs/lexer/side_table.hpp>
 #include <eggs/lexer/token.hpp>
+#include <eggs/lexer/token_range.hpp>
+#include <eggs/lexer/token_table.hpp>
 #include <eggs/lexer/tokenize.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <variant>
+#include <vector>
 
 namespace eggs { namespace lexers
 {
@@ -34,8 +48,74 @@ namespace eggs { namespace lexers
         struct index_of<T, U, Ts...>
           : std::integral_constant<std::size_t, 1 + index_of<T, Ts...>::value>
         {};
+
+        inline std::size_t countr_zero(std::uint64_t bits) noexcept
+        {
+            assert(bits != 0);
+#if defined(__GNUC__)
+            return static_cast<std::size_t>(__builtin_ctzll(bits));
+#else
+            std::size_t count = 0;
+            for (; (bits & 1) == 0; bits >>= 1)
+                ++count;
+            return count;
+#endif
+        }
+
+        template <typename T, typename ...Ts>
+        struct is_one_of
+          : std::disjunction<std::is_same<T, Ts>...>
+        {};
+
+        ///////////////////////////////////////////////////////////////////////
+        struct skip_none
+        {
+            constexpr bool operator()(std::size_t /*category*/) const noexcept
+            {
+                return false;
+            }
+        };
+
+        template <std::size_t N>
+        struct skip_mask
+        {
+            bool skip[N];
+
+            constexpr bool operator()(std::size_t category) const noexcept
+            {
+                return skip[category];
+            }
+        };
     }
 
+    template <typename Lexer, typename ...SkipRules>
+    class skip_lexer;
+
+    template <typename Lexer>
+    class indexed_lexer;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Iterator, std::size_t N>
+    //! struct count_result;
+    //!
+    //! Class template `count_result` holds the outcome of counting the tokens
+    //! of a lexer with `N` categories over an input range.
+    template <typename Iterator, std::size_t N>
+    struct count_result
+    {
+        //! Iterator last;
+        //!
+        //! An iterator denoting the start of the range that produced an
+        //! invalid token, if one was found; otherwise, the end of the input
+        //! range.
+        Iterator last;
+
+        //! std::array<std::size_t, N> counts;
+        //!
+        //! The number of tokens demarcated for each category.
+        std::array<std::size_t, N> counts;
+    };
+
     ///////////////////////////////////////////////////////////////////////////
     //! template <class ...Rules>
     //! class lexer;
@@ -146,6 +226,31 @@ namespace eggs { namespace lexers
                 first, last);
         }
 
+        //! template <class Iterator, class Sentinel>
+        //! lexers::token<Iterator> demarcate(Iterator first, Sentinel last) const
+        //!
+        //! \requires The type `Iterator` shall satisfy ForwardIterator. The
+        //!  types `Sentinel` and `Iterator` shall satisfy Sentinel.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Equivalent to `return tokenize(first, last).raw();`,
+        //!  except that the associated value of the token is never evaluated.
+        template <typename Iterator, typename Sentinel>
+        lexers::token<Iterator> demarcate(Iterator first, Sentinel last) const
+        {
+            if (first == last)
+            {
+                return lexers::token<Iterator>{
+                    lexers::token<Iterator>::no_category, first, first};
+            }
+
+            auto match = _match(
+                std::make_index_sequence<sizeof...(Rules)>{},
+                first, last);
+            return lexers::token<Iterator>{match.category(), first, match.mark};
+        }
+
         //! template <class Iterator, class Sentinel, class OutputIterator>
         //! Iterator operator()(Iterator first, Sentinel last, OutputIterator result) const
         //!
@@ -187,7 +292,657 @@ namespace eggs { namespace lexers
             return first;
         }
 
+        //! template <class ExecutionPolicy, class Iterator, class Sentinel, class OutputIterator>
+        //! Iterator operator()(ExecutionPolicy&& policy, Iterator first, Sentinel last, OutputIterator result) const
+        //!
+        //! \requires The requirements of `operator()(first, last, result)`.
+        //!  If `policy` allows parallelization, the tokenization rules of the
+        //!  lexer shall be safe to invoke concurrently.
+        //!
+        //! \effects If `policy` allows parallelization, `Iterator` satisfies
+        //!  RandomAccessIterator and `Sentinel` is `Iterator`, equivalent to
+        //!  `return parallel_lex(*this, first, last, result, opts);`, where
+        //!  `opts` are the options of `policy` (if any). Otherwise, equivalent
+        //!  to `return operator()(first, last, result);`.
+        //!
+        //! \remarks This function shall not participate in overload
+        //!  resolution unless `is_execution_policy_v<decay_t<ExecutionPolicy>>`
+        //!  is `true`. Input ranges shorter than `opts.min_chunk_size` are
+        //!  lexed sequentially.
+        template <
+            typename ExecutionPolicy,
+            typename Iterator, typename Sentinel,
+            typename OutputIterator,
+            typename Enable = std::enable_if_t<
+                is_execution_policy_v<std::decay_t<ExecutionPolicy>>>>
+        Iterator operator()(
+            ExecutionPolicy&& policy,
+            Iterator first, Sentinel last,
+            OutputIterator result) const
+        {
+            if constexpr (std::is_same_v<Iterator, Sentinel>
+             && std::is_base_of_v<std::random_access_iterator_tag,
+                    typename std::iterator_traits<Iterator>::iterator_category>)
+            {
+                return lexers::parallel_lex(*this, first, last, result,
+                    detail::parallel_options_of(policy));
+            } else {
+                return (*this)(first, last, result);
+            }
+        }
+
+        //! template <class PackedToken = packed_token, class Iterator, class Sentinel, class OutputIterator>
+        //! Iterator pack(Iterator first, Sentinel last, OutputIterator result) const
+        //!
+        //! \requires `PackedToken` shall be an instance of
+        //!  `basic_packed_token`, and `sizeof...(Rules)` shall not exceed
+        //!  `PackedToken::max_category + 1`. The type `Iterator` shall satisfy
+        //!  ForwardIterator. The types `Sentinel` and `Iterator` shall satisfy
+        //!  Sentinel. The type `OutputIterator` shall satisfy OutputIterator.
+        //!  The expression `*result = PackedToken{}` shall be valid.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Copies into `[result, ...)` the tokens that
+        //!  `operator()(first, last, result)` would produce, each packed as
+        //!  a `PackedToken` whose offset is relative to `first`, until an
+        //!  invalid token is found or the range is exhausted.
+        //!
+        //! \returns An iterator denoting the start of the range that produced
+        //!  an invalid token, if one was found; otherwise, an iterator
+        //!  denoting the end of the input range.
+        //!
+        //! \throws `std::length_error` if the offset or the length of a
+        //!  lexeme is too large to be represented by `PackedToken`.
+        //!
+        //! \remarks Tokens are demarcated as if by successive calls to
+        //!  `demarcate`; no `evaluate` hook is invoked.
+        template <
+            typename PackedToken = packed_token,
+            typename Iterator, typename Sentinel,
+            typename OutputIterator>
+        Iterator pack(
+            Iterator first, Sentinel last,
+            OutputIterator result) const
+        {
+            static_assert(sizeof...(Rules) <= PackedToken::max_category + 1);
+
+            constexpr std::make_index_sequence<sizeof...(Rules)> is{};
+            std::size_t offset = 0;
+            while (first != last)
+            {
+                auto match = _match(is, first, last);
+                std::size_t const category = match.category();
+                if (category == token<Iterator>::no_category)
+                    break;
+
+                assert(match.mark != first && "lexeme cannot be empty");
+                std::size_t const length =
+                    std::size_t(std::distance(first, match.mark));
+                if (offset > PackedToken::max_offset
+                 || length > PackedToken::max_length)
+                    throw std::length_error("lexeme too large to pack");
+
+                *result++ = PackedToken(category, offset, length);
+                offset += length;
+                first = match.mark;
+            }
+            return first;
+        }
+
+        //! template <class Iterator, class Sentinel, class Value>
+        //! Iterator tabulate(Iterator first, Sentinel last, token_table<Iterator, Value>& table) const
+        //!
+        //! \requires `Value` shall be either `void` or
+        //!  `token<Iterator, Sentinel>::value_type`. The type `Iterator`
+        //!  shall satisfy ForwardIterator. The types `Sentinel` and `Iterator`
+        //!  shall satisfy Sentinel.
+        //!
+        //! \preconditions `[table.base(), first)` and `[first, last)` shall
+        //!  denote valid ranges.
+        //!
+        //! \effects Appends to `table` a row for each token that
+        //!  `operator()(first, last, result)` would produce, until an invalid
+        //!  token is found or the range is exhausted.
+        //!
+        //! \returns An iterator denoting the start of the range that produced
+        //!  an invalid token, if one was found; otherwise, an iterator
+        //!  denoting the end of the input range.
+        //!
+        //! \remarks If `Value` is `void`, tokens are demarcated as if by
+        //!  successive calls to `demarcate` and no `evaluate` hook is
+        //!  invoked; otherwise, as if by successive calls to `tokenize`.
+        template <
+            typename Iterator, typename Sentinel,
+            typename Value>
+        Iterator tabulate(
+            Iterator first, Sentinel last,
+            token_table<Iterator, Value>& table) const
+        {
+            static_assert(std::is_void_v<Value> || std::is_same_v<
+                Value, typename token<Iterator, Sentinel>::value_type>);
+
+            std::size_t offset =
+                std::size_t(std::distance(table.base(), first));
+            while (first != last)
+            {
+                if constexpr (std::is_void_v<Value>)
+                {
+                    lexers::token<Iterator> const token =
+                        demarcate(first, last);
+                    if (token.category() == token.no_category)
+                        break;
+
+                    assert(token.first != token.second && "lexeme cannot be empty");
+                    std::size_t const length =
+                        std::size_t(std::distance(token.first, token.second));
+                    table.emplace_back(token.category(), offset, length);
+                    offset += length;
+                    first = token.second;
+                } else {
+                    token<Iterator, Sentinel> token = tokenize(first, last);
+                    if (token.category() == token.no_category)
+                        break;
+
+                    assert(token.first != token.second && "lexeme cannot be empty");
+                    std::size_t const length =
+                        std::size_t(std::distance(token.first, token.second));
+                    table.emplace_back(
+                        token.category(), offset, length,
+                        std::move(token.value));
+                    offset += length;
+                    first = token.second;
+                }
+            }
+            return first;
+        }
+
+        //! template <class Documents, class Sink>
+        //! void tokenize_batch(Documents const& documents, Sink&& sink, parallel_options const& opts) const
+        //!
+        //! Let `Iterator` be `decltype(std::begin(documents[0]))`.
+        //!
+        //! \requires `Documents` shall be a random access range of ranges,
+        //!  for which `std::size(documents)` and `documents[i]` are valid.
+        //!  The type `Iterator` shall satisfy ForwardIterator. The expression
+        //!  `sink(i, tokens, last)` shall be valid, where `i` is a
+        //!  `std::size_t`, `tokens` is an lvalue of type
+        //!  `std::vector<token<Iterator>>` and `last` is an `Iterator`. The
+        //!  tokenization rules of the lexer shall be safe to invoke
+        //!  concurrently.
+        //!
+        //! \effects For each document `documents[i]`, on one of up to
+        //!  `opts.threads` threads, including the calling one, lexes the
+        //!  document as if by `last = operator()(std::begin(documents[i]),
+        //!  std::end(documents[i]), std::back_inserter(tokens))` and then
+        //!  calls `sink(i, tokens, last)`. Documents are split evenly among
+        //!  threads, and threads that run out of documents steal from others.
+        //!
+        //! \throws Any exception thrown by `sink`, after the documents being
+        //!  lexed are completed; remaining documents are not lexed.
+        //!
+        //! \remarks `tokens` is a scratch buffer reused by the calling thread,
+        //!  which is cleared before each document; `sink` may move from it.
+        //!  Each index is passed to `sink` exactly once, so `sink` can store
+        //!  results into per-document slots without synchronization.
+        template <typename Documents, typename Sink>
+        void tokenize_batch(
+            Documents const& documents, Sink&& sink,
+            parallel_options const& opts) const
+        {
+            using iterator = decltype(std::begin(documents[0]));
+            std::size_t const size = std::size(documents);
+            std::size_t const threads = (std::min)(
+                detail::parallel_threads(opts), size);
+
+            std::vector<std::vector<token<iterator>>> scratch(threads);
+            detail::parallel_for_stealing(size, threads,
+                [&](std::size_t t, std::size_t i)
+                {
+                    std::vector<token<iterator>>& tokens = scratch[t];
+                    tokens.clear();
+
+                    iterator const last = (*this)(
+                        std::begin(documents[i]), std::end(documents[i]),
+                        std::back_inserter(tokens));
+                    sink(i, tokens, last);
+                });
+        }
+
+        //! template <class Documents, class Sink>
+        //! void tokenize_batch(Documents const& documents, Sink&& sink) const
+        //!
+        //! \effects Equivalent to `tokenize_batch(documents, sink,
+        //!  parallel_options())`.
+        template <typename Documents, typename Sink>
+        void tokenize_batch(Documents const& documents, Sink&& sink) const
+        {
+            return tokenize_batch(documents, sink, parallel_options());
+        }
+
+        //! template <class Records, class Sink>
+        //! void tokenize_lanes(Records const& records, Sink&& sink) const
+        //!
+        //! Let `Iterator` be `decltype(std::begin(records[0]))`.
+        //!
+        //! \requires `Records` shall be a random access range of ranges, for
+        //!  which `std::size(records)` and `records[i]` are valid. The type
+        //!  `Iterator` shall satisfy ForwardIterator. The expression
+        //!  `sink(i, tokens, last)` shall be valid, where `i` is a
+        //!  `std::size_t`, `tokens` is an lvalue of type
+        //!  `std::vector<token<Iterator>>` and `last` is an `Iterator`.
+        //!
+        //! \effects For each record `records[i]`, lexes the record as if by
+        //!  `last = operator()(std::begin(records[i]), std::end(records[i]),
+        //!  std::back_inserter(tokens))` and then calls `sink(i, tokens,
+        //!  last)`, in an unspecified order.
+        //!
+        //! \remarks If every type in `Rules` is, or is derived from,
+        //!  `char_class_rule` without an associated value, and there are no
+        //!  more than 64 of them, records are lexed in an interleaved fashion,
+        //!  each one in its own lane. At every step each lane narrows down the
+        //!  set of rules still matching by looking up its next character in a
+        //!  table of rule masks, so that many short records are lexed at once
+        //!  without per-call overhead. Otherwise, records are lexed one after
+        //!  another. Rules derived from `char_class_rule` shall demarcate
+        //!  tokens as it does. `tokens` is a scratch buffer, which is cleared
+        //!  before each record; `sink` may move from it.
+        template <typename Records, typename Sink>
+        void tokenize_lanes(Records const& records, Sink&& sink) const
+        {
+            using iterator = decltype(std::begin(records[0]));
+            if constexpr (sizeof...(Rules) <= 64
+             && std::is_void_v<typename token<iterator>::value_type>
+             && std::conjunction_v<std::is_base_of<char_class_rule, Rules>...>)
+            {
+                _tokenize_lanes<iterator>(
+                    std::make_index_sequence<sizeof...(Rules)>{},
+                    records, sink);
+            } else {
+                std::vector<token<iterator>> tokens;
+                for (std::size_t i = 0, size = std::size(records); i < size; ++i)
+                {
+                    tokens.clear();
+                    iterator const last = (*this)(
+                        std::begin(records[i]), std::end(records[i]),
+                        std::back_inserter(tokens));
+                    sink(i, tokens, last);
+                }
+            }
+        }
+
+        //! template <class Iterator, class Sentinel>
+        //! token_range<lexer, Iterator, Sentinel> tokens(Iterator first, Sentinel last) const
+        //!
+        //! \requires The type `Iterator` shall satisfy ForwardIterator. The
+        //!  types `Sentinel` and `Iterator` shall satisfy Sentinel.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \returns A lazy, single-pass range of the tokens demarcated by the
+        //!  tokenization rules of the lexer in the given input range `[first,
+        //!  last)`, until an invalid token is found or the range is exhausted.
+        //!
+        //! \remarks Tokens are demarcated as if by successive calls to
+        //!  `tokenize`, each one as the range iterator is incremented onto it.
+        //!  The returned range refers to `*this`.
+        template <typename Iterator, typename Sentinel>
+        token_range<lexer, Iterator, Sentinel> tokens(
+            Iterator first, Sentinel last) const
+        {
+            return token_range<lexer, Iterator, Sentinel>(*this, first, last);
+        }
+
+        //! template <class Iterator, class Sentinel, class Visitor>
+        //! Iterator for_each(Iterator first, Sentinel last, Visitor&& visitor) const
+        //!
+        //! \requires The type `Iterator` shall satisfy ForwardIterator. The
+        //!  types `Sentinel` and `Iterator` shall satisfy Sentinel. For each
+        //!  category `I` whose tokenization rule produces an associated value
+        //!  of type `Vi`, the expression `visitor(std::integral_constant<
+        //!  std::size_t, I>{}, first, first, std::declval<Vi>())` shall be
+        //!  valid; for every other category `I`, the expression `visitor(
+        //!  std::integral_constant<std::size_t, I>{}, first, first)` shall be
+        //!  valid.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects For each token demarcated by the tokenization rules of the
+        //!  lexer in the given input range `[first, last)`, until an invalid
+        //!  token is found or the range is exhausted, calls `visitor` with
+        //!  the category of the token as an integral constant, the iterators
+        //!  denoting its lexeme and its associated value (if any).
+        //!
+        //! \returns An iterator denoting the start of the range that produced
+        //!  an invalid token, if one was found; otherwise, an iterator
+        //!  denoting the end of the input range.
+        //!
+        //! \remarks Tokens are demarcated as if by successive calls to
+        //!  `tokenize`, but no `token` object is ever constructed. The
+        //!  associated value is passed to `visitor` as an rvalue of the type
+        //!  produced by the demarcating rule, rather than as `Value`.
+        template <
+            typename Iterator, typename Sentinel,
+            typename Visitor>
+        Iterator for_each(
+            Iterator first, Sentinel last,
+            Visitor&& visitor) const
+        {
+            return _drive(first, last, detail::skip_none{},
+                [&visitor](Iterator first, auto& match)
+                {
+                    detail::_visit_match(first, match, visitor,
+                        std::make_index_sequence<sizeof...(Rules)>{});
+                });
+        }
+
+        //! template <class Iterator, class Sentinel>
+        //! count_result<Iterator, sizeof...(Rules)> count(Iterator first, Sentinel last) const
+        //!
+        //! \requires The type `Iterator` shall satisfy ForwardIterator. The
+        //!  types `Sentinel` and `Iterator` shall satisfy Sentinel.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Counts, for each category, the tokens demarcated by the
+        //!  tokenization rules of the lexer in the given input range
+        //!  `[first, last)` until an invalid token is found or the range is
+        //!  exhausted.
+        //!
+        //! \returns A `count_result` whose member `last` is an iterator
+        //!  denoting the start of the range that produced an invalid token,
+        //!  if one was found, or the end of the input range otherwise; and
+        //!  whose member `counts` holds the number of tokens demarcated for
+        //!  each category.
+        //!
+        //! \remarks Tokens are demarcated as if by successive calls to
+        //!  `tokenize`, but no `token` object is ever constructed and no
+        //!  `evaluate` hook of the tokenization rules is invoked; use
+        //!  `for_each` when the associated values are needed.
+        template <typename Iterator, typename Sentinel>
+        count_result<Iterator, sizeof...(Rules)> count(
+            Iterator first, Sentinel last) const
+        {
+            count_result<Iterator, sizeof...(Rules)> result{first, {}};
+            result.last = _drive(first, last, detail::skip_none{},
+                [&result](Iterator, auto const& match)
+                {
+                    ++result.counts[match.category()];
+                });
+            return result;
+        }
+
+        //! template <class Iterator, class Sentinel>
+        //! bool validate(Iterator first, Sentinel last) const
+        //!
+        //! \requires The type `Iterator` shall satisfy ForwardIterator. The
+        //!  types `Sentinel` and `Iterator` shall satisfy Sentinel.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \returns `true` if the tokenization rules of the lexer demarcate
+        //!  tokens over the entire input range `[first, last)`; otherwise,
+        //!  `false`.
+        //!
+        //! \remarks Tokens are demarcated as if by successive calls to
+        //!  `tokenize`, but no `token` object is ever constructed and no
+        //!  `evaluate` hook of the tokenization rules is invoked.
+        template <typename Iterator, typename Sentinel>
+        bool validate(Iterator first, Sentinel last) const
+        {
+            return _drive(first, last, detail::skip_none{},
+                [](Iterator, auto const&) {}) == last;
+        }
+
+        //! template <class ...Targets, class Iterator, class Sentinel, class OutputIterator>
+        //! Iterator sparse(Iterator first, Sentinel last, OutputIterator result, char_set const& anchors, char_set const& resync) const
+        //!
+        //! \requires Each type in the parameter pack `Targets` shall occur
+        //!  exactly once in the parameter pack `Rules`. The type `Iterator`
+        //!  shall satisfy ForwardIterator. The types `Sentinel` and `Iterator`
+        //!  shall satisfy Sentinel. The type `OutputIterator` shall satisfy
+        //!  OutputIterator. The expression `*result = token<Iterator>{}`
+        //!  shall be valid.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range. Every
+        //!  token demarcated by one of the tokenization rules in `Targets`
+        //!  starts with a character in `anchors`. For every character in
+        //!  `resync` found in `[first, last)`, a token demarcated as if by
+        //!  `operator()(first, last, result)` ends right after it.
+        //!
+        //! \effects Copies into `[result, ...)` the tokens demarcated by the
+        //!  tokenization rules in `Targets` that `operator()(first, last,
+        //!  result)` would produce, until an invalid token is found or the
+        //!  range is exhausted. Only the input between the last character in
+        //!  `resync` that precedes a character in `anchors` and the end of the
+        //!  token that contains it is tokenized; the rest of the input is
+        //!  searched for characters in `anchors` and skipped.
+        //!
+        //! \returns An iterator denoting the start of the range that produced
+        //!  an invalid token, if one was found while tokenizing; otherwise,
+        //!  an iterator denoting the end of the input range.
+        //!
+        //! \remarks Invalid tokens within skipped input are not detected. No
+        //!  `evaluate` hook is invoked for tokens of categories not in
+        //!  `Targets`.
+        template <
+            typename ...Targets,
+            typename Iterator, typename Sentinel,
+            typename OutputIterator>
+        Iterator sparse(
+            Iterator first, Sentinel last,
+            OutputIterator result,
+            char_set const& anchors, char_set const& resync) const
+        {
+            static_assert(sizeof...(Targets) > 0);
+            static_assert(((
+                category_of<Targets>() < sizeof...(Rules)) && ...));
+
+            using value = typename token<Iterator, Sentinel>::value_type;
+            constexpr std::make_index_sequence<sizeof...(Rules)> is{};
+            constexpr detail::skip_mask<sizeof...(Rules)> skip = {{
+                !detail::is_one_of<Rules, Targets...>::value...}};
+
+            while (first != last)
+            {
+                Iterator const anchor =
+                    detail::find_first_of(first, last, anchors);
+                if (anchor == last)
+                    return anchor;
+
+                first = detail::find_past_last_of(first, anchor, resync);
+                for (auto distance = std::distance(first, anchor);
+                    distance >= 0 && first != last;)
+                {
+                    auto match = _match(is, first, last);
+                    std::size_t const category = match.category();
+                    if (category == token<Iterator>::no_category)
+                        return first;
+
+                    assert(match.mark != first && "lexeme cannot be empty");
+                    distance -= std::distance(first, match.mark);
+                    if (!skip(category))
+                    {
+                        *result++ = std::visit(
+                            detail::make_token<Iterator, value>{
+                                category, first, match.mark},
+                            match.state);
+                    }
+                    first = match.mark;
+                }
+            }
+            return first;
+        }
+
+        //! template <class Iterator, class Sentinel, class OutputIterator>
+        //! Iterator recover(Iterator first, Sentinel last, OutputIterator result, char_set const& resync) const
+        //!
+        //! \requires The type `Iterator` shall satisfy ForwardIterator. The
+        //!  types `Sentinel` and `Iterator` shall satisfy Sentinel. The type
+        //!  `OutputIterator` shall satisfy OutputIterator. The expression
+        //!  `*result = token<Iterator>{}` shall be valid.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Copies into `[result, ...)` tokens demarcated by the
+        //!  tokenization rules of the lexer in the given input range
+        //!  `[first, last)` until the range is exhausted. Whenever an invalid
+        //!  token is found, the input is skipped up to the next position that
+        //!  starts with a character in `resync` and produces a valid token,
+        //!  and a token with category `no_category` whose lexeme is the
+        //!  skipped input is copied into `[result, ...)` in its place.
+        //!
+        //! \returns An iterator denoting the end of the input range.
+        //!
+        //! \remarks The associated value (if any) of a token with category
+        //!  `no_category` is value-initialized. Valid tokens that start with
+        //!  a character not in `resync` are demarcated as usual when they
+        //!  follow a valid token, but are skipped as part of the invalid input
+        //!  when they follow an invalid token.
+        template <
+            typename Iterator, typename Sentinel,
+            typename OutputIterator>
+        Iterator recover(
+            Iterator first, Sentinel last,
+            OutputIterator result,
+            char_set const& resync) const
+        {
+            using token = token<Iterator, Sentinel>;
+            using value = typename token::value_type;
+            constexpr std::make_index_sequence<sizeof...(Rules)> is{};
+
+            Iterator error = first;
+            bool in_error = false;
+            while (first != last)
+            {
+                auto match = _match(is, first, last);
+                std::size_t const category = match.category();
+                if (category == token::no_category)
+                {
+                    if (!in_error)
+                    {
+                        error = first;
+                        in_error = true;
+                    }
+                    first = detail::find_first_of(
+                        std::next(first), last, resync);
+                    continue;
+                }
+
+                if (in_error)
+                {
+                    *result++ = token{token::no_category, error, first};
+                    in_error = false;
+                }
+
+                assert(match.mark != first && "lexeme cannot be empty");
+                *result++ = std::visit(
+                    detail::make_token<Iterator, value>{
+                        category, first, match.mark},
+                    match.state);
+                first = match.mark;
+            }
+            if (in_error)
+                *result++ = token{token::no_category, error, first};
+            return first;
+        }
+
+        //! template <class Iterator, class Sentinel, class OutputIterator>
+        //! Iterator recover(Iterator first, Sentinel last, OutputIterator result) const
+        //!
+        //! \effects Equivalent to `return recover(first, last, result,
+        //!  resync)`, where `resync` is a `char_set` containing every
+        //!  character.
+        template <
+            typename Iterator, typename Sentinel,
+            typename OutputIterator>
+        Iterator recover(
+            Iterator first, Sentinel last,
+            OutputIterator result) const
+        {
+            constexpr char_set any = char_set().insert('\x00', '\xff');
+            return recover(first, last, std::move(result), any);
+        }
+
+        //! template <class ...SkipRules>
+        //! constexpr skip_lexer<lexer, SkipRules...> skip() const
+        //!
+        //! \requires Each type in the parameter pack `SkipRules` shall occur
+        //!  exactly once in the parameter pack `Rules`.
+        //!
+        //! \returns A `skip_lexer` that drops tokens demarcated by any of the
+        //!  tokenization rules in `SkipRules`, constructed from `*this`.
+        template <typename ...SkipRules>
+        constexpr skip_lexer<lexer, SkipRules...> skip() const
+        {
+            return skip_lexer<lexer, SkipRules...>(*this);
+        }
+
+        //! constexpr indexed_lexer<lexer> indexed() const
+        //!
+        //! \returns An `indexed_lexer` that stores associated values in an
+        //!  `indexed_value`, constructed from `*this`.
+        constexpr indexed_lexer<lexer> indexed() const
+        {
+            return indexed_lexer<lexer>(*this);
+        }
+
+        //! template <std::size_t Threshold = 16>
+        //! lexer<side_rule<Rules, Threshold>...> out_of_line(side_table& table) const
+        //!
+        //! \returns A lexer whose tokenization rules are copies of those of
+        //!  `*this`, each adapted by a `side_rule` that moves associated
+        //!  values larger than `Threshold` bytes into `table`.
+        template <std::size_t Threshold = 16>
+        lexer<side_rule<Rules, Threshold>...> out_of_line(side_table& table) const
+        {
+            return std::apply([&table](Rules const&... rules)
+                {
+                    return lexer<side_rule<Rules, Threshold>...>(
+                        side_rule<Rules, Threshold>(table, rules)...);
+                }, _rules);
+        }
+
     private:
+        template <typename Lexer, typename ...SkipRules>
+        friend class skip_lexer;
+
+        template <typename Lexer>
+        friend class indexed_lexer;
+
+        template <
+            typename Iterator, typename Sentinel,
+            typename Skip, typename F>
+        Iterator _drive(
+            Iterator first, Sentinel last,
+            Skip const& skip, F&& f) const
+        {
+            constexpr std::make_index_sequence<sizeof...(Rules)> is{};
+            while (first != last)
+            {
+                auto match = _match(is, first, last);
+                std::size_t const category = match.category();
+                if (category == token<Iterator>::no_category)
+                    break;
+
+                assert(match.mark != first && "lexeme cannot be empty");
+                if (!skip(category))
+                    f(first, match);
+                first = match.mark;
+            }
+            return first;
+        }
+
+        template <
+            std::size_t ...Is,
+            typename Iterator, typename Sentinel>
+        auto _match(
+            std::index_sequence<Is...> is,
+            Iterator first, Sentinel last) const
+        {
+            return detail::_match(first, last, is, std::get<Is>(_rules)...);
+        }
+
         template <
             std::size_t ...Is,
             typename Iterator, typename Sentinel>
@@ -198,10 +953,379 @@ namespace eggs { namespace lexers
             return lexers::tokenize(first, last, std::get<Is>(_rules)...);
         }
 
+        template <
+            typename Iterator,
+            std::size_t ...Is,
+            typename Records, typename Sink>
+        void _tokenize_lanes(
+            std::index_sequence<Is...>,
+            Records const& records, Sink& sink) const
+        {
+            using mask = std::conditional_t<
+                (sizeof...(Rules) <= 32), std::uint32_t, std::uint64_t>;
+            constexpr mask all = mask(-1) >> (sizeof(mask) * 8 - sizeof...(Rules));
+            constexpr std::size_t lanes = 16;
+
+            // the rules that accept each character, and none at the end
+            std::array<mask, 257> table{};
+            for (std::size_t c = 0; c < 256; ++c)
+            {
+                table[c] = ((static_cast<char_class_rule const&>(
+                    std::get<Is>(_rules)).set().contains(static_cast<char>(c))
+                      ? mask(1) << Is : mask(0)) | ...);
+            }
+
+            struct lane
+            {
+                std::size_t record;
+                Iterator first;
+                Iterator next;
+                Iterator last;
+                mask alive;
+                std::vector<token<Iterator>> tokens;
+            };
+            std::array<lane, lanes> ls;
+            std::array<bool, lanes> active{};
+            std::array<mask, lanes> matches;
+
+            std::size_t const size = std::size(records);
+            std::size_t next_record = 0;
+            auto load = [&](lane& l) -> bool
+            {
+                if (next_record == size)
+                    return false;
+                l.record = next_record++;
+                l.first = l.next = std::begin(records[l.record]);
+                l.last = std::end(records[l.record]);
+                l.alive = all;
+                l.tokens.clear();
+                return true;
+            };
+
+            std::size_t busy = 0;
+            for (std::size_t i = 0; i < lanes; ++i)
+            {
+                active[i] = load(ls[i]);
+                busy += active[i];
+            }
+
+            while (busy != 0)
+            {
+                for (std::size_t i = 0; i < lanes; ++i)
+                {
+                    lane const& l = ls[i];
+                    matches[i] = active[i] ? l.alive & table[l.next != l.last
+                      ? static_cast<unsigned char>(*l.next) : 256] : 0;
+                }
+
+                for (std::size_t i = 0; i < lanes; ++i)
+                {
+                    if (!active[i])
+                        continue;
+
+                    lane& l = ls[i];
+                    if (matches[i] != 0)
+                    {
+                        l.alive = matches[i];
+                        ++l.next;
+                    } else if (l.next != l.first) {
+                        // the longest match, first one on ties
+                        l.tokens.emplace_back(
+                            detail::countr_zero(l.alive), l.first, l.next);
+                        l.first = l.next;
+                        l.alive = all;
+                    } else {
+                        // the end of the record, or an invalid token
+                        sink(l.record, l.tokens, l.next);
+                        if (!load(l))
+                        {
+                            active[i] = false;
+                            --busy;
+                        }
+                    }
+                }
+            }
+        }
+
     private:
         std::tuple<Rules...> _rules;
     };
 
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer, class ...SkipRules>
+    //! class skip_lexer;
+    //!
+    //! Class template `skip_lexer` represents a lexical analyzer that drops
+    //! the tokens of some of the categories of an underlying `lexer`, such as
+    //! whitespace and comments, as part of demarcating them.
+    //!
+    //! \requires `Lexer` shall be an instance of `lexer`. Each type in the
+    //!  parameter pack `SkipRules` shall occur exactly once in the parameter
+    //!  pack of tokenization rules of `Lexer`.
+    template <typename Lexer, typename ...SkipRules>
+    class skip_lexer;
+
+    template <typename ...Rules, typename ...SkipRules>
+    class skip_lexer<lexer<Rules...>, SkipRules...>
+    {
+        using _lexer = lexer<Rules...>;
+
+    public:
+        //! template <class Iterator, class Sentinel = Iterator>
+        //! using token = typename Lexer::template token<Iterator, Sentinel>;
+        template <typename Iterator, typename Sentinel = Iterator>
+        using token = typename _lexer::template token<Iterator, Sentinel>;
+
+    public:
+        //! constexpr explicit skip_lexer(Lexer const& lexer)
+        //!
+        //! \effects Initializes the underlying lexer with `lexer`.
+        constexpr explicit skip_lexer(_lexer const& lexer)
+          : _base(lexer)
+        {}
+
+        //! template <class Rule>
+        //! static constexpr std::size_t category_of() noexcept
+        //!
+        //! \effects Equivalent to `return Lexer::template
+        //!  category_of<Rule>();`.
+        template <typename Rule>
+        static constexpr std::size_t category_of() noexcept
+        {
+            return _lexer::template category_of<Rule>();
+        }
+
+        //! static constexpr bool is_skipped(std::size_t category) noexcept
+        //!
+        //! \returns `true` if `category` corresponds to one of the
+        //!  tokenization rules in `SkipRules`; otherwise, `false`.
+        static constexpr bool is_skipped(std::size_t category) noexcept
+        {
+            return category < sizeof...(Rules) && _skip(category);
+        }
+
+        //! template <class Iterator, class Sentinel, class OutputIterator>
+        //! Iterator operator()(Iterator first, Sentinel last, OutputIterator result) const
+        //!
+        //! \effects Equivalent to `Lexer::operator()(first, last, result)`,
+        //!  except that no skipped token is copied into `[result, ...)`.
+        //!
+        //! \remarks Skipped tokens are demarcated but never constructed, and
+        //!  no `evaluate` hook is invoked for them.
+        template <
+            typename Iterator, typename Sentinel,
+            typename OutputIterator>
+        Iterator operator()(
+            Iterator first, Sentinel last,
+            OutputIterator result) const
+        {
+            using value = typename token<Iterator, Sentinel>::value_type;
+            return _base._drive(first, last, _skip,
+                [&result](Iterator first, auto& match)
+                {
+                    *result++ = std::visit(
+                        detail::make_token<Iterator, value>{
+                            match.category(), first, match.mark},
+                        match.state);
+                });
+        }
+
+        //! template <class Iterator, class Sentinel, class Visitor>
+        //! Iterator for_each(Iterator first, Sentinel last, Visitor&& visitor) const
+        //!
+        //! \effects Equivalent to `Lexer::for_each(first, last, visitor)`,
+        //!  except that `visitor` is not called for skipped tokens.
+        //!
+        //! \remarks No `evaluate` hook is invoked for skipped tokens.
+        template <
+            typename Iterator, typename Sentinel,
+            typename Visitor>
+        Iterator for_each(
+            Iterator first, Sentinel last,
+            Visitor&& visitor) const
+        {
+            return _base._drive(first, last, _skip,
+                [&visitor](Iterator first, auto& match)
+                {
+                    detail::_visit_match(first, match, visitor,
+                        std::make_index_sequence<sizeof...(Rules)>{});
+                });
+        }
+
+    private:
+        static_assert(((
+            _lexer::template category_of<SkipRules>() < sizeof...(Rules)) && ...));
+
+        static constexpr detail::skip_mask<sizeof...(Rules)> _skip = {{
+            detail::is_one_of<Rules, SkipRules...>::value...}};
+
+        _lexer _base;
+    };
+
+    template <typename ...Rules, typename ...SkipRules>
+    constexpr detail::skip_mask<sizeof...(Rules)>
+        skip_lexer<lexer<Rules...>, SkipRules...>::_skip;
+
+    ///////////////////////////////////////////////////////////////////////////
+    namespace detail
+    {
+        template <typename Iterator, typename Value>
+        struct make_indexed_token
+        {
+            using token = lexers::token<Iterator, Value>;
+
+            std::size_t category;
+            Iterator first, last;
+
+            template <std::size_t I, typename Ri>
+            token operator()(
+                index<I> /*category*/,
+                intermediate_state<Ri>& /*match*/) const
+            {
+                return token{category, first, last};
+            }
+
+            template <std::size_t I, typename Ri, typename Pi>
+            token operator()(
+                index<I> /*category*/,
+                intermediate_state<Ri, Pi>& match) const
+            {
+                detail::evaluate(match.rule, category, first, last,
+                    std::move(match.payload));
+                return token{category, first, last};
+            }
+
+            template <std::size_t I, typename Ri, typename Pi, typename Vi>
+            token operator()(
+                index<I> /*category*/,
+                intermediate_state<Ri, Pi, Vi>& match) const
+            {
+                return token{category, first, last, std::in_place_index<I>,
+                    detail::evaluate(match.rule, category, first, last,
+                        std::move(match.payload))};
+            }
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer>
+    //! class indexed_lexer;
+    //!
+    //! Class template `indexed_lexer` represents a lexical analyzer that
+    //! demarcates tokens as an underlying `lexer` does, but whose associated
+    //! values are stored in an `indexed_value` selected by the category of
+    //! the token, rather than in a `std::variant` that repeats it.
+    //!
+    //! \requires `Lexer` shall be an instance of `lexer`. The associated
+    //!  value type of each of its tokenization rules shall be trivially
+    //!  copyable.
+    template <typename Lexer>
+    class indexed_lexer;
+
+    template <typename ...Rules>
+    class indexed_lexer<lexer<Rules...>>
+    {
+        using _lexer = lexer<Rules...>;
+
+    public:
+        //! template <class Iterator, class Sentinel = Iterator>
+        //! using token = lexers::token<Iterator, indexed_value<Vs...>>;
+        //!
+        //! Where `Vs` is the type of the associated value of each tokenization
+        //! rule in `Rules` in order, if any; otherwise, `std::monostate`.
+        template <typename Iterator, typename Sentinel = Iterator>
+        using token = lexers::token<Iterator, indexed_value<
+            detail::indexed_alternative_t<typename detail::tokenization_rule_traits<
+                Rules, Iterator, Sentinel>::value>...>>;
+
+    public:
+        //! constexpr explicit indexed_lexer(Lexer const& lexer)
+        //!
+        //! \effects Initializes the underlying lexer with `lexer`.
+        constexpr explicit indexed_lexer(_lexer const& lexer)
+          : _base(lexer)
+        {}
+
+        //! template <class Rule>
+        //! static constexpr std::size_t category_of() noexcept
+        //!
+        //! \effects Equivalent to `return Lexer::template
+        //!  category_of<Rule>();`.
+        template <typename Rule>
+        static constexpr std::size_t category_of() noexcept
+        {
+            return _lexer::template category_of<Rule>();
+        }
+
+        //! template <class Iterator, class Sentinel>
+        //! token<Iterator, Sentinel> tokenize(Iterator first, Sentinel last) const
+        //!
+        //! \effects Equivalent to `Lexer::tokenize(first, last)`, except
+        //!  that the associated value is stored in an `indexed_value`.
+        template <typename Iterator, typename Sentinel>
+        token<Iterator, Sentinel> tokenize(Iterator first, Sentinel last) const
+        {
+            if (first == last)
+                return token<Iterator, Sentinel>{
+                    token<Iterator, Sentinel>::no_category, first, first};
+
+            auto match = _base._match(
+                std::make_index_sequence<sizeof...(Rules)>{},
+                first, last);
+            return _make<Sentinel>(first, match);
+        }
+
+        //! template <class Iterator, class Sentinel, class OutputIterator>
+        //! Iterator operator()(Iterator first, Sentinel last, OutputIterator result) const
+        //!
+        //! \effects Equivalent to `Lexer::operator()(first, last, result)`,
+        //!  except that the associated values of the tokens copied into
+        //!  `[result, ...)` are stored in an `indexed_value`.
+        template <
+            typename Iterator, typename Sentinel,
+            typename OutputIterator>
+        Iterator operator()(
+            Iterator first, Sentinel last,
+            OutputIterator result) const
+        {
+            return _base._drive(first, last, detail::skip_none{},
+                [&result](Iterator first, auto& match)
+                {
+                    *result++ = _make<Sentinel>(first, match);
+                });
+        }
+
+    private:
+        template <typename Sentinel, typename Iterator, typename Match>
+        static token<Iterator, Sentinel> _make(Iterator first, Match& match)
+        {
+            return _make<Sentinel>(first, match,
+                std::make_index_sequence<sizeof...(Rules)>{});
+        }
+
+        template <
+            typename Sentinel, typename Iterator, typename Match,
+            std::size_t ...Is>
+        static token<Iterator, Sentinel> _make(
+            Iterator first, Match& match, std::index_sequence<Is...>)
+        {
+            using value = typename token<Iterator, Sentinel>::value_type;
+            detail::make_indexed_token<Iterator, value> const make{
+                match.category(), first, match.mark};
+
+            token<Iterator, Sentinel> result{match.category(), first, match.mark};
+            std::size_t const category = match.category();
+            (void)((category == Is && (result = make(
+                detail::index<Is>{}, *std::get_if<Is + 1>(&match.state)), true))
+              || ...);
+            return result;
+        }
+
+    private:
+        _lexer _base;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
     //! template <class Rule, class Lexer>
     //! struct category_of;
     //!
@@ -0,0 +1,299 @@
+//! \file eggs/lexer/mapped_file.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_MAPPED_FILE_HPP
+#define EGGS_LEXER_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <system_error>
+#include <utility>
+
+#if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#  define EGGS_LEXER_HAS_MMAP 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#else
+#  define EGGS_LEXER_HAS_MMAP 0
+#  include <cstdio>
+#  include <cstring>
+#  include <memory>
+#endif
+
+namespace eggs { namespace lexers
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! class mapped_file;
+    //!
+    //! Class `mapped_file` represents the contents of a file mapped read-only
+    //! into memory, suitable as a contiguous input range for a lexer. The
+    //! contents are followed by a number of readable zero bytes, so that
+    //! rules may read past the end of the input in fixed-size blocks.
+    //!
+    //! \remarks On platforms without `mmap`, the contents are read into a
+    //!  heap-allocated buffer instead.
+    class mapped_file
+    {
+    public:
+        //! struct options;
+        //!
+        //! Class `options` holds the parameters for mapping a file.
+        struct options
+        {
+            //! bool populate = false;
+            //!
+            //! Whether to prefault the whole mapping up front (`MAP_POPULATE`),
+            //! where supported.
+            bool populate = false;
+
+            //! bool sequential = true;
+            //!
+            //! Whether to advise the kernel that the mapping will be read
+            //! sequentially (`MADV_SEQUENTIAL`), which enables aggressive
+            //! read-ahead.
+            bool sequential = true;
+
+            //! std::size_t padding = 64;
+            //!
+            //! The number of readable zero bytes that follow the contents.
+            std::size_t padding = 64;
+        };
+
+    public:
+        //! constexpr mapped_file() noexcept;
+        //!
+        //! \postconditions `data() == nullptr` and `size() == 0`.
+        constexpr mapped_file() noexcept
+          : _data(nullptr)
+          , _size(0)
+          , _length(0)
+        {}
+
+        //! explicit mapped_file(char const* path);
+        //!
+        //! \effects Equivalent to `mapped_file(path, options())`.
+        explicit mapped_file(char const* path)
+          : mapped_file()
+        {
+            _map(path, options());
+        }
+
+        //! mapped_file(char const* path, options const& opts);
+        //!
+        //! \effects Maps the contents of the file at `path` into memory,
+        //!  according to `opts`.
+        //!
+        //! \postconditions `[data(), data() + size() + opts.padding)` is a
+        //!  readable range, where the last `opts.padding` bytes are zero.
+        //!
+        //! \throws `std::system_error` if the file cannot be opened or
+        //!  mapped.
+        mapped_file(char const* path, options const& opts)
+          : mapped_file()
+        {
+            _map(path, opts);
+        }
+
+        //! mapped_file(mapped_file&& other) noexcept;
+        //!
+        //! \effects Transfers the mapping from `other` to `*this`.
+        //!
+        //! \postconditions `other.data() == nullptr` and `other.size() == 0`.
+        mapped_file(mapped_file&& other) noexcept
+          : _data(std::exchange(other._data, nullptr))
+          , _size(std::exchange(other._size, 0))
+          , _length(std::exchange(other._length, 0))
+        {}
+
+        //! mapped_file& operator=(mapped_file&& other) noexcept;
+        //!
+        //! \effects Unmaps the contents of `*this`, if any, then transfers
+        //!  the mapping from `other` to `*this`.
+        //!
+        //! \postconditions `other.data() == nullptr` and `other.size() == 0`.
+        mapped_file& operator=(mapped_file&& other) noexcept
+        {
+            if (this != &other)
+            {
+                _unmap();
+                _data = std::exchange(other._data, nullptr);
+                _size = std::exchange(other._size, 0);
+                _length = std::exchange(other._length, 0);
+            }
+            return *this;
+        }
+
+        //! ~mapped_file();
+        //!
+        //! \effects Unmaps the contents, if any.
+        ~mapped_file()
+        {
+            _unmap();
+        }
+
+        //! char const* data() const noexcept;
+        //!
+        //! \returns A pointer to the contents of the file.
+        char const* data() const noexcept
+        {
+            return _data;
+        }
+
+        //! std::size_t size() const noexcept;
+        //!
+        //! \returns The size of the contents of the file.
+        std::size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        //! bool empty() const noexcept;
+        //!
+        //! \returns `size() == 0`.
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        //! char const* begin() const noexcept;
+        //!
+        //! \returns `data()`.
+        char const* begin() const noexcept
+        {
+            return _data;
+        }
+
+        //! char const* end() const noexcept;
+        //!
+        //! \returns `data() + size()`.
+        char const* end() const noexcept
+        {
+            return _data + _size;
+        }
+
+    private:
+#if EGGS_LEXER_HAS_MMAP
+        void _map(char const* path, options const& opts)
+        {
+            int const fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if (fd == -1)
+                throw std::system_error(errno, std::generic_category(), path);
+
+            struct ::stat st;
+            if (::fstat(fd, &st) == -1)
+            {
+                int const error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), path);
+            }
+
+            std::size_t const page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            std::size_t const size = static_cast<std::size_t>(st.st_size);
+            std::size_t const file_length = (size + page - 1) / page * page;
+            std::size_t const length =
+                (size + opts.padding + page - 1) / page * page;
+
+            // reserve zero-filled pages for the padding, then map the file
+            // over the start of them
+            void* const base = length == 0 ? nullptr : ::mmap(
+                nullptr, length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (base == MAP_FAILED)
+            {
+                int const error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), path);
+            }
+
+            if (file_length != 0)
+            {
+                int flags = MAP_PRIVATE | MAP_FIXED;
+#ifdef MAP_POPULATE
+                if (opts.populate)
+                    flags |= MAP_POPULATE;
+#endif
+                if (::mmap(base, file_length, PROT_READ, flags, fd, 0) == MAP_FAILED)
+                {
+                    int const error = errno;
+                    ::munmap(base, length);
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), path);
+                }
+
+                if (opts.sequential)
+                    ::posix_madvise(base, file_length, POSIX_MADV_SEQUENTIAL);
+            }
+            ::close(fd);
+
+            _data = static_cast<char const*>(base);
+            _size = size;
+            _length = length;
+        }
+
+        void _unmap() noexcept
+        {
+            if (_length != 0)
+                ::munmap(const_cast<char*>(_data), _length);
+        }
+#else
+        void _map(char const* path, options const& opts)
+        {
+            std::FILE* const file = std::fopen(path, "rb");
+            if (file == nullptr)
+                throw std::system_error(errno, std::generic_category(), path);
+
+            std::unique_ptr<char[]> buffer;
+            std::size_t size = 0;
+            std::size_t capacity = 0;
+            for (;;)
+            {
+                if (size == capacity)
+                {
+                    std::size_t const new_capacity =
+                        capacity == 0 ? 65536 : capacity * 2;
+                    std::unique_ptr<char[]> new_buffer(
+                        new char[new_capacity + opts.padding]);
+                    if (size != 0)
+                        std::memcpy(new_buffer.get(), buffer.get(), size);
+                    buffer = std::move(new_buffer);
+                    capacity = new_capacity;
+                }
+
+                std::size_t const read = std::fread(
+                    buffer.get() + size, 1, capacity - size, file);
+                size += read;
+                if (read == 0)
+                    break;
+            }
+
+            bool const failed = std::ferror(file) != 0;
+            std::fclose(file);
+            if (failed)
+                throw std::system_error(EIO, std::generic_category(), path);
+
+            std::memset(buffer.get() + size, 0, opts.padding);
+            _data = buffer.release();
+            _size = size;
+            _length = capacity + opts.padding;
+        }
+
+        void _unmap() noexcept
+        {
+            delete[] _data;
+        }
+#endif
+
+    private:
+        char const* _data;
+        std::size_t _size;
+        std::size_t _length;
+    };
+}}
+
+#endif /*EGGS_LEXER_MAPPED_FILE_HPP*/
@@ -0,0 +1,179 @@
+//! \file eggs/lexer/packed_token.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_PACKED_TOKEN_HPP
+#define EGGS_LEXER_PACKED_TOKEN_HPP
+
+#include <eggs/lexer/token.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace eggs { namespace lexers
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Word>
+    //! class basic_packed_token;
+    //!
+    //! Class template `basic_packed_token` represents a categorized lexeme as
+    //! a pair of words: the offset of the lexeme from the start of the input,
+    //! and its length packed together with its category in the low 8 bits.
+    //! It holds no iterators and no associated value, so that large arrays of
+    //! tokens take a fraction of the memory a `token` takes.
+    //!
+    //! \requires The type `Word` shall be an unsigned integer type of at
+    //!  least 32 bits.
+    template <typename Word>
+    class basic_packed_token
+    {
+        static_assert(std::is_unsigned_v<Word>);
+        static_assert(std::numeric_limits<Word>::digits >= 32);
+
+        static constexpr int _category_bits = 8;
+        static constexpr Word _category_mask = (Word(1) << _category_bits) - 1;
+
+    public:
+        //! static constexpr std::size_t no_category = std::size_t(-1);
+        static constexpr std::size_t no_category = std::size_t(-1);
+
+        //! static constexpr std::size_t max_category = 254;
+        //!
+        //! The greatest category that can be represented.
+        static constexpr std::size_t max_category = _category_mask - 1;
+
+        //! static constexpr std::size_t max_offset = see-below;
+        //!
+        //! The greatest offset that can be represented, which is the greatest
+        //! value of `Word`.
+        static constexpr std::size_t max_offset =
+            std::numeric_limits<Word>::max() <
+                std::numeric_limits<std::size_t>::max()
+              ? std::size_t(std::numeric_limits<Word>::max())
+              : std::numeric_limits<std::size_t>::max();
+
+        //! static constexpr std::size_t max_length = see-below;
+        //!
+        //! The greatest length that can be represented, which is the greatest
+        //! value of `Word` shifted right by 8 bits.
+        static constexpr std::size_t max_length =
+            std::size_t(std::numeric_limits<Word>::max() >> _category_bits);
+
+    public:
+        //! constexpr basic_packed_token() noexcept;
+        //!
+        //! \effects Initializes the category to `no_category`, and the offset
+        //!  and length to zero.
+        constexpr basic_packed_token() noexcept
+          : _offset(0)
+          , _length_category(_category_mask)
+        {}
+
+        //! constexpr basic_packed_token(std::size_t category, std::size_t offset, std::size_t length) noexcept;
+        //!
+        //! \preconditions `category <= max_category || category == no_category`,
+        //!  `offset <= max_offset`, and `length <= max_length`.
+        //!
+        //! \effects Initializes the category, offset and length with the
+        //!  given values.
+        constexpr basic_packed_token(
+            std::size_t category, std::size_t offset, std::size_t length) noexcept
+          : _offset(Word(offset))
+          , _length_category(
+                Word(length) << _category_bits
+              | (category != no_category ? Word(category) : _category_mask))
+        {}
+
+        //! constexpr std::size_t category() const noexcept;
+        //!
+        //! \returns The category of the token.
+        constexpr std::size_t category() const noexcept
+        {
+            Word const category = _length_category & _category_mask;
+            return category != _category_mask
+              ? std::size_t(category) : no_category;
+        }
+
+        //! constexpr std::size_t offset() const noexcept;
+        //!
+        //! \returns The offset of the lexeme from the start of the input.
+        constexpr std::size_t offset() const noexcept
+        {
+            return std::size_t(_offset);
+        }
+
+        //! constexpr std::size_t length() const noexcept;
+        //!
+        //! \returns The length of the lexeme.
+        constexpr std::size_t length() const noexcept
+        {
+            return std::size_t(_length_category >> _category_bits);
+        }
+
+        //! template <class Iterator>
+        //! constexpr token<Iterator> unpack(Iterator base) const;
+        //!
+        //! \requires The type `Iterator` shall satisfy ForwardIterator.
+        //!
+        //! \preconditions `base` denotes the start of the input the token was
+        //!  demarcated from.
+        //!
+        //! \returns `token<Iterator>(category(), first, first + length())`,
+        //!  where `first` is `base + offset()`.
+        template <typename Iterator>
+        constexpr token<Iterator> unpack(Iterator base) const
+        {
+            using difference_type =
+                typename std::iterator_traits<Iterator>::difference_type;
+
+            Iterator const first = std::next(base, difference_type(_offset));
+            return token<Iterator>(category(), first,
+                std::next(first, difference_type(length())));
+        }
+
+        //! friend constexpr bool operator==(basic_packed_token const& lhs, basic_packed_token const& rhs) noexcept;
+        //!
+        //! \returns `true` if `lhs` and `rhs` have the same category, offset
+        //!  and length; otherwise, `false`.
+        friend constexpr bool operator==(
+            basic_packed_token const& lhs, basic_packed_token const& rhs) noexcept
+        {
+            return lhs._offset == rhs._offset
+                && lhs._length_category == rhs._length_category;
+        }
+
+        //! friend constexpr bool operator!=(basic_packed_token const& lhs, basic_packed_token const& rhs) noexcept;
+        //!
+        //! \returns `!(lhs == rhs)`.
+        friend constexpr bool operator!=(
+            basic_packed_token const& lhs, basic_packed_token const& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        Word _offset;
+        Word _length_category;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! using packed_token = basic_packed_token<std::uint32_t>;
+    //!
+    //! An 8 byte token, for inputs of up to 4 GiB and lexemes of up to
+    //! 16 MiB.
+    using packed_token = basic_packed_token<std::uint32_t>;
+
+    //! using wide_packed_token = basic_packed_token<std::uint64_t>;
+    //!
+    //! A 16 byte token, for inputs and lexemes of any practical size.
+    using wide_packed_token = basic_packed_token<std::uint64_t>;
+}}
+
+#endif /*EGGS_LEXER_PACKED_TOKEN_HPP*/
@@ -0,0 +1,747 @@
+//! \file eggs/lexer/parallel.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_PARALLEL_HPP
+#define EGGS_LEXER_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(EGGS_LEXER_STD_EXECUTION)
+#  define EGGS_LEXER_HAS_STD_EXECUTION 1
+#  include <execution>
+#else
+#  define EGGS_LEXER_HAS_STD_EXECUTION 0
+#endif
+
+namespace eggs { namespace lexers
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! struct parallel_options;
+    //!
+    //! Class `parallel_options` holds the parameters of a parallel lexical
+    //! analysis.
+    struct parallel_options
+    {
+        //! std::size_t threads = 0;
+        //!
+        //! The maximum number of threads to use, including the calling one,
+        //! or `0` for `std::thread::hardware_concurrency()`.
+        std::size_t threads = 0;
+
+        //! std::size_t min_chunk_size = 65536;
+        //!
+        //! The minimum size of the input range lexed by a single thread.
+        std::size_t min_chunk_size = 65536;
+    };
+
+    namespace execution
+    {
+        ///////////////////////////////////////////////////////////////////////
+        //! struct sequenced_policy;
+        //!
+        //! Class `sequenced_policy` is an execution policy type that requires
+        //! lexical analysis to be sequential.
+        struct sequenced_policy {};
+
+        //! struct parallel_policy;
+        //!
+        //! Class `parallel_policy` is an execution policy type that allows
+        //! lexical analysis to be parallelized.
+        struct parallel_policy
+        {
+            //! parallel_options options;
+            parallel_options options;
+
+            //! constexpr parallel_policy with(parallel_options const& opts) const noexcept;
+            //!
+            //! \returns A `parallel_policy` with the given options.
+            constexpr parallel_policy with(
+                parallel_options const& opts) const noexcept
+            {
+                return parallel_policy{opts};
+            }
+        };
+
+        //! inline constexpr sequenced_policy seq{};
+        inline constexpr sequenced_policy seq{};
+
+        //! inline constexpr parallel_policy par{};
+        inline constexpr parallel_policy par{};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! struct is_execution_policy;
+    //!
+    //! Class template `is_execution_policy` is a trait that determines
+    //! whether `T` is an execution policy type, which is the case for those
+    //! in namespace `execution`, and for standard ones when
+    //! `EGGS_LEXER_STD_EXECUTION` is defined.
+    template <typename T>
+    struct is_execution_policy
+#if EGGS_LEXER_HAS_STD_EXECUTION
+      : std::is_execution_policy<T>
+#else
+      : std::false_type
+#endif
+    {};
+
+    template <>
+    struct is_execution_policy<execution::sequenced_policy>
+      : std::true_type
+    {};
+
+    template <>
+    struct is_execution_policy<execution::parallel_policy>
+      : std::true_type
+    {};
+
+    //! template <class T>
+    //! inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+    template <typename T>
+    inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        inline parallel_options parallel_options_of(
+            execution::sequenced_policy const&) noexcept
+        {
+            parallel_options opts;
+            opts.threads = 1;
+            return opts;
+        }
+
+        inline parallel_options parallel_options_of(
+            execution::parallel_policy const& policy) noexcept
+        {
+            return policy.options;
+        }
+
+#if EGGS_LEXER_HAS_STD_EXECUTION
+        template <typename ExecutionPolicy>
+        parallel_options parallel_options_of(
+            ExecutionPolicy const& /*policy*/) noexcept
+        {
+            parallel_options opts;
+            if constexpr (std::is_same_v<
+                    ExecutionPolicy, std::execution::sequenced_policy>)
+                opts.threads = 1;
+#  if __cpp_lib_execution >= 201902L
+            if constexpr (std::is_same_v<
+                    ExecutionPolicy, std::execution::unsequenced_policy>)
+                opts.threads = 1;
+#  endif
+            return opts;
+        }
+#endif
+
+        ///////////////////////////////////////////////////////////////////////
+        inline std::size_t parallel_threads(parallel_options const& opts) noexcept
+        {
+            std::size_t const threads = opts.threads != 0
+              ? opts.threads : std::thread::hardware_concurrency();
+            return threads != 0 ? threads : 1;
+        }
+
+        // Calls `f(i)` for each `i` in `[0, n)` on up to `threads` threads,
+        // including the calling one, and rethrows the first exception thrown.
+        template <typename F>
+        void parallel_for(std::size_t n, std::size_t threads, F const& f)
+        {
+            std::atomic<std::size_t> next(0);
+            std::mutex mutex;
+            std::exception_ptr error;
+            auto work = [&]() noexcept
+            {
+                for (std::size_t i; (i = next++) < n;)
+                {
+                    try
+                    {
+                        f(i);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error)
+                            error = std::current_exception();
+                        next = n;
+                    }
+                }
+            };
+
+            std::vector<std::thread> workers;
+            threads = (std::min)(threads, n);
+            for (std::size_t t = 1; t < threads; ++t)
+                workers.emplace_back(work);
+            work();
+            for (std::thread& worker : workers)
+                worker.join();
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // A range of indices owned by a thread, packed as `[begin, end)` into
+        // a single word so that it can be shrunk from either side atomically:
+        // the owner takes from the front, and thieves take from the back.
+        struct alignas(64) stealing_range
+        {
+            std::atomic<std::uint64_t> bounds;
+
+            static constexpr std::uint64_t pack(
+                std::uint64_t begin, std::uint64_t end) noexcept
+            {
+                return begin | (end << 32);
+            }
+
+            bool pop(std::size_t& index) noexcept
+            {
+                std::uint64_t value = bounds.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    std::uint64_t const begin = value & 0xffffffffu;
+                    std::uint64_t const end = value >> 32;
+                    if (begin == end)
+                        return false;
+                    if (bounds.compare_exchange_weak(value, pack(begin + 1, end)))
+                    {
+                        index = static_cast<std::size_t>(begin);
+                        return true;
+                    }
+                }
+            }
+
+            bool steal_into(stealing_range& thief, std::size_t& index) noexcept
+            {
+                std::uint64_t value = bounds.load(std::memory_order_relaxed);
+                for (;;)
+                {
+                    std::uint64_t const begin = value & 0xffffffffu;
+                    std::uint64_t const end = value >> 32;
+                    if (begin == end)
+                        return false;
+
+                    std::uint64_t const split = end - (end - begin + 1) / 2;
+                    if (bounds.compare_exchange_weak(value, pack(begin, split)))
+                    {
+                        // the thief's own range is empty, and only grows here
+                        thief.bounds.store(pack(split + 1, end));
+                        index = static_cast<std::size_t>(split);
+                        return true;
+                    }
+                }
+            }
+        };
+
+        // Calls `f(t, i)` for each `i` in `[0, n)` on up to `threads` threads,
+        // including the calling one, where `t` is the index of the calling
+        // thread. Indices are initially split evenly, and threads that run
+        // out of them steal half of the remaining ones of another thread.
+        template <typename F>
+        void parallel_for_stealing(std::size_t n, std::size_t threads, F const& f)
+        {
+            assert(n <= 0xffffffffu && "too many indices");
+
+            threads = (std::max)((std::min)(threads, n), std::size_t(1));
+            std::unique_ptr<stealing_range[]> ranges(new stealing_range[threads]);
+            for (std::size_t t = 0; t < threads; ++t)
+            {
+                ranges[t].bounds.store(stealing_range::pack(
+                    n * t / threads, n * (t + 1) / threads));
+            }
+
+            std::atomic<bool> stop(false);
+            std::mutex mutex;
+            std::exception_ptr error;
+            auto work = [&](std::size_t t) noexcept
+            {
+                std::size_t index;
+                for (;;)
+                {
+                    if (!ranges[t].pop(index))
+                    {
+                        bool stolen = false;
+                        for (std::size_t v = 1; v < threads && !stolen; ++v)
+                        {
+                            stolen = ranges[(t + v) % threads].steal_into(
+                                ranges[t], index);
+                        }
+                        if (!stolen)
+                            return;
+                    }
+                    if (stop.load(std::memory_order_relaxed))
+                        return;
+
+                    try
+                    {
+                        f(t, index);
+                    } catch (...) {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error)
+                            error = std::current_exception();
+                        stop = true;
+                    }
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (std::size_t t = 1; t < threads; ++t)
+                workers.emplace_back(work, t);
+            work(0);
+            for (std::thread& worker : workers)
+                worker.join();
+
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The tokens demarcated from a speculative start, up to the first
+        // token boundary at or past the start of the next chunk.
+        template <typename Lexer, typename Iterator>
+        struct speculative_chunk
+        {
+            using token = typename Lexer::template token<Iterator>;
+
+            std::vector<token> tokens;
+            Iterator stop;
+            bool error;
+        };
+
+        template <typename Lexer, typename Iterator>
+        void lex_chunk(
+            Lexer const& lexer,
+            Iterator first, Iterator bound, Iterator last,
+            speculative_chunk<Lexer, Iterator>& chunk)
+        {
+            using token = typename Lexer::template token<Iterator>;
+
+            chunk.error = false;
+            while (first < bound)
+            {
+                token t = lexer.tokenize(first, last);
+                if (t.category() == token::no_category)
+                {
+                    chunk.error = true;
+                    break;
+                }
+                first = t.second;
+                chunk.tokens.push_back(std::move(t));
+            }
+            chunk.stop = first;
+        }
+
+        // Stitches together the speculative chunks, re-lexing from the true
+        // position of the input wherever it is not the start of a token of
+        // the chunk it falls in, until both are back in sync.
+        template <typename Lexer, typename Iterator, typename OutputIterator>
+        Iterator merge_chunks(
+            Lexer const& lexer,
+            Iterator first, Iterator last,
+            std::vector<speculative_chunk<Lexer, Iterator>>& chunks,
+            OutputIterator& result)
+        {
+            using token = typename Lexer::template token<Iterator>;
+
+            for (speculative_chunk<Lexer, Iterator>& chunk : chunks)
+            {
+                // the common case, where the previous chunk ends exactly at
+                // the start of this one
+                if (!chunk.tokens.empty() && chunk.tokens.front().first == first)
+                {
+                    result = std::move(
+                        chunk.tokens.begin(), chunk.tokens.end(), result);
+                    first = chunk.stop;
+                }
+
+                while (first < chunk.stop)
+                {
+                    auto const sync = std::lower_bound(
+                        chunk.tokens.begin(), chunk.tokens.end(), first,
+                        [](token const& t, Iterator const& mark)
+                        { return t.first < mark; });
+                    if (sync != chunk.tokens.end() && sync->first == first)
+                    {
+                        result = std::move(sync, chunk.tokens.end(), result);
+                        first = chunk.stop;
+                        break;
+                    }
+
+                    token t = lexer.tokenize(first, last);
+                    if (t.category() == token::no_category)
+                        return first;
+                    first = t.second;
+                    *result++ = std::move(t);
+                }
+                if (first == chunk.stop && chunk.error)
+                    return first;
+            }
+            return first;
+        }
+
+        template <typename Lexer, typename Iterator, typename OutputIterator>
+        Iterator parallel_lex(
+            Lexer const& lexer,
+            std::vector<Iterator> const& bounds, Iterator last,
+            OutputIterator& result, std::size_t threads)
+        {
+            std::vector<speculative_chunk<Lexer, Iterator>> chunks(bounds.size());
+            detail::parallel_for(chunks.size(), threads,
+                [&](std::size_t i)
+                {
+                    Iterator const bound = i + 1 < bounds.size()
+                      ? bounds[i + 1] : last;
+                    detail::lex_chunk(lexer, bounds[i], bound, last, chunks[i]);
+                });
+
+            return detail::merge_chunks(
+                lexer, bounds.front(), last, chunks, result);
+        }
+
+        ///////////////////////////////////////////////////////////////////////
+        // The number of tokens demarcated from a speculative start, up to the
+        // first token boundary at or past the start of the next chunk, and
+        // the starts of those within the leading window where a resync is
+        // expected to happen.
+        template <typename Iterator>
+        struct counted_chunk
+        {
+            std::size_t count;
+            std::vector<Iterator> starts;
+            Iterator stop;
+            bool error;
+        };
+
+        constexpr std::size_t sync_window = 4096;
+
+        template <typename Lexer, typename Iterator>
+        void count_chunk(
+            Lexer const& lexer,
+            Iterator first, Iterator bound, Iterator last,
+            counted_chunk<Iterator>& chunk)
+        {
+            Iterator const window = first + (std::min)(
+                bound - first, static_cast<std::ptrdiff_t>(sync_window));
+
+            chunk.count = 0;
+            chunk.error = false;
+            while (first < bound)
+            {
+                auto const t = lexer.demarcate(first, last);
+                if (t.category() == t.no_category)
+                {
+                    chunk.error = true;
+                    break;
+                }
+                if (first < window)
+                    chunk.starts.push_back(first);
+                ++chunk.count;
+                first = t.second;
+            }
+            chunk.stop = first;
+        }
+
+        // The true start of a chunk, and the number of tokens it contributes.
+        template <typename Iterator>
+        struct chunk_span
+        {
+            Iterator first;
+            std::size_t count;
+        };
+
+        template <typename Lexer, typename Iterator>
+        Iterator merge_counts(
+            Lexer const& lexer,
+            Iterator first, Iterator last,
+            std::vector<counted_chunk<Iterator>> const& chunks,
+            std::vector<chunk_span<Iterator>>& spans)
+        {
+            bool done = false;
+            for (counted_chunk<Iterator> const& chunk : chunks)
+            {
+                chunk_span<Iterator> span{first, 0};
+                while (!done && first < chunk.stop)
+                {
+                    auto const sync = std::lower_bound(
+                        chunk.starts.begin(), chunk.starts.end(), first);
+                    if (sync != chunk.starts.end() && *sync == first)
+                    {
+                        span.count += chunk.count
+                          - static_cast<std::size_t>(sync - chunk.starts.begin());
+                        first = chunk.stop;
+                        break;
+                    }
+
+                    auto const t = lexer.demarcate(first, last);
+                    if (t.category() == t.no_category)
+                    {
+                        done = true;
+                        break;
+                    }
+                    ++span.count;
+                    first = t.second;
+                }
+                if (first == chunk.stop && chunk.error)
+                    done = true;
+                spans.push_back(span);
+            }
+            return first;
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer, class RandomAccessIterator, class OutputIterator>
+    //! RandomAccessIterator parallel_lex(
+    //!     Lexer const& lexer,
+    //!     RandomAccessIterator first, RandomAccessIterator last,
+    //!     OutputIterator result, parallel_options const& opts)
+    //!
+    //! \requires `Lexer` shall be an instance of `lexer`. The type
+    //!  `RandomAccessIterator` shall satisfy RandomAccessIterator. The type
+    //!  `OutputIterator` shall satisfy OutputIterator. The expression
+    //!  `*result = token{}` shall be valid, where `token` is `typename
+    //!  Lexer::template token<RandomAccessIterator>`. The tokenization rules
+    //!  of `lexer` shall be safe to invoke concurrently.
+    //!
+    //! \preconditions `[first, last)` shall denote a valid range.
+    //!
+    //! \effects Equivalent to `return lexer(first, last, result);`, except
+    //!  that the input range is split into chunks that are lexed in parallel,
+    //!  each one from a speculative start at its beginning. A chunk is used
+    //!  as is when the previous one ends exactly at its start; otherwise,
+    //!  only the prefix up to its first token that starts at a true token
+    //!  boundary is lexed again.
+    //!
+    //! \remarks The tokens copied into `[result, ...)`, and the iterator
+    //!  returned, are the same as those of `lexer(first, last, result)`.
+    //!  Tokens of speculative starts that are discarded may be evaluated.
+    template <
+        typename Lexer, typename RandomAccessIterator,
+        typename OutputIterator>
+    RandomAccessIterator parallel_lex(
+        Lexer const& lexer,
+        RandomAccessIterator first, RandomAccessIterator last,
+        OutputIterator result, parallel_options const& opts)
+    {
+        std::size_t const size = static_cast<std::size_t>(last - first);
+        std::size_t const chunks = (std::min)(
+            detail::parallel_threads(opts),
+            size / (std::max)(opts.min_chunk_size, std::size_t(1)));
+        if (chunks <= 1)
+            return lexer(first, last, result);
+
+        std::vector<RandomAccessIterator> bounds;
+        for (std::size_t i = 0; i < chunks; ++i)
+            bounds.push_back(first + static_cast<std::ptrdiff_t>(size * i / chunks));
+
+        return detail::parallel_lex(lexer, bounds, last, result, chunks);
+    }
+
+    //! template <class Lexer, class RandomAccessIterator, class OutputIterator>
+    //! RandomAccessIterator parallel_lex(
+    //!     Lexer const& lexer,
+    //!     RandomAccessIterator first, RandomAccessIterator last,
+    //!     OutputIterator result)
+    //!
+    //! \effects Equivalent to `return parallel_lex(lexer, first, last,
+    //!  result, parallel_options());`.
+    template <
+        typename Lexer, typename RandomAccessIterator,
+        typename OutputIterator>
+    RandomAccessIterator parallel_lex(
+        Lexer const& lexer,
+        RandomAccessIterator first, RandomAccessIterator last,
+        OutputIterator result)
+    {
+        return lexers::parallel_lex(
+            lexer, first, last, result, parallel_options());
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer, class RandomAccessIterator>
+    //! RandomAccessIterator parallel_lex_into(
+    //!     Lexer const& lexer,
+    //!     RandomAccessIterator first, RandomAccessIterator last,
+    //!     std::vector<typename Lexer::template token<RandomAccessIterator>>& tokens,
+    //!     parallel_options const& opts)
+    //!
+    //! \requires The requirements of `parallel_lex`.
+    //!
+    //! \effects Equivalent to `return lexer(first, last,
+    //!  std::back_inserter(tokens));`, except that the input range is split
+    //!  into chunks that are lexed in two parallel passes. The first pass
+    //!  counts the tokens of each chunk, resynchronizing speculative starts
+    //!  as in `parallel_lex`, and a prefix sum over the counts gives the
+    //!  position of each chunk in `tokens`. The second pass then lexes each
+    //!  chunk again, directly into its position.
+    //!
+    //! \remarks `tokens` is resized once, and no token is copied after
+    //!  being demarcated. The first pass never evaluates token values.
+    template <typename Lexer, typename RandomAccessIterator>
+    RandomAccessIterator parallel_lex_into(
+        Lexer const& lexer,
+        RandomAccessIterator first, RandomAccessIterator last,
+        std::vector<typename Lexer::template token<RandomAccessIterator>>& tokens,
+        parallel_options const& opts)
+    {
+        std::size_t const size = static_cast<std::size_t>(last - first);
+        std::size_t const chunks = (std::min)(
+            detail::parallel_threads(opts),
+            size / (std::max)(opts.min_chunk_size, std::size_t(1)));
+        if (chunks <= 1)
+            return lexer(first, last, std::back_inserter(tokens));
+
+        std::vector<RandomAccessIterator> bounds;
+        for (std::size_t i = 0; i < chunks; ++i)
+            bounds.push_back(first + static_cast<std::ptrdiff_t>(size * i / chunks));
+
+        // count
+        std::vector<detail::counted_chunk<RandomAccessIterator>> counts(chunks);
+        detail::parallel_for(chunks, chunks,
+            [&](std::size_t i)
+            {
+                RandomAccessIterator const bound = i + 1 < chunks
+                  ? bounds[i + 1] : last;
+                detail::count_chunk(lexer, bounds[i], bound, last, counts[i]);
+            });
+
+        std::vector<detail::chunk_span<RandomAccessIterator>> spans;
+        spans.reserve(chunks);
+        RandomAccessIterator const stop = detail::merge_counts(
+            lexer, first, last, counts, spans);
+
+        // prefix sum
+        std::vector<std::size_t> offsets(chunks + 1, tokens.size());
+        for (std::size_t i = 0; i < chunks; ++i)
+            offsets[i + 1] = offsets[i] + spans[i].count;
+        tokens.resize(offsets.back());
+
+        // write
+        detail::parallel_for(chunks, chunks,
+            [&](std::size_t i)
+            {
+                RandomAccessIterator iter = spans[i].first;
+                for (std::size_t j = offsets[i]; j != offsets[i + 1]; ++j)
+                {
+                    tokens[j] = lexer.tokenize(iter, last);
+                    iter = tokens[j].second;
+                }
+            });
+
+        return stop;
+    }
+
+    //! template <class Lexer, class RandomAccessIterator>
+    //! RandomAccessIterator parallel_lex_into(
+    //!     Lexer const& lexer,
+    //!     RandomAccessIterator first, RandomAccessIterator last,
+    //!     std::vector<typename Lexer::template token<RandomAccessIterator>>& tokens)
+    //!
+    //! \effects Equivalent to `return parallel_lex_into(lexer, first, last,
+    //!  tokens, parallel_options());`.
+    template <typename Lexer, typename RandomAccessIterator>
+    RandomAccessIterator parallel_lex_into(
+        Lexer const& lexer,
+        RandomAccessIterator first, RandomAccessIterator last,
+        std::vector<typename Lexer::template token<RandomAccessIterator>>& tokens)
+    {
+        return lexers::parallel_lex_into(
+            lexer, first, last, tokens, parallel_options());
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer, class RandomAccessIterator, class OutputIterator, class Char>
+    //! RandomAccessIterator parallel_lex_records(
+    //!     Lexer const& lexer,
+    //!     RandomAccessIterator first, RandomAccessIterator last,
+    //!     OutputIterator result, Char separator,
+    //!     parallel_options const& opts)
+    //!
+    //! \requires The requirements of `parallel_lex`. The expression
+    //!  `*first == separator` shall be valid.
+    //!
+    //! \effects Equivalent to `return lexer(first, last, result);`, except
+    //!  that the input range is split into partitions right after a record
+    //!  separator near equal-size offsets, which are lexed in parallel and
+    //!  concatenated in order.
+    //!
+    //! \remarks Partitioning relies on the contract that a record separator
+    //!  is only ever the last character of a token, so that a token never
+    //!  spans a partition boundary. The contract is validated at each
+    //!  boundary by checking that the previous partition ends exactly at
+    //!  it; where it does not hold, the partition is resynchronized as in
+    //!  `parallel_lex`, so the result is still that of `lexer(first, last,
+    //!  result)`.
+    template <
+        typename Lexer, typename RandomAccessIterator,
+        typename OutputIterator, typename Char>
+    RandomAccessIterator parallel_lex_records(
+        Lexer const& lexer,
+        RandomAccessIterator first, RandomAccessIterator last,
+        OutputIterator result, Char separator,
+        parallel_options const& opts)
+    {
+        std::size_t const size = static_cast<std::size_t>(last - first);
+        std::size_t const chunks = (std::min)(
+            detail::parallel_threads(opts),
+            size / (std::max)(opts.min_chunk_size, std::size_t(1)));
+        if (chunks <= 1)
+            return lexer(first, last, result);
+
+        std::vector<RandomAccessIterator> bounds(1, first);
+        for (std::size_t i = 1; i < chunks; ++i)
+        {
+            RandomAccessIterator bound = std::find(
+                (std::max)(bounds.back(),
+                    first + static_cast<std::ptrdiff_t>(size * i / chunks)),
+                last, separator);
+            if (bound == last || ++bound == last)
+                break;
+            if (bound != bounds.back())
+                bounds.push_back(bound);
+        }
+        if (bounds.size() == 1)
+            return lexer(first, last, result);
+
+        return detail::parallel_lex(lexer, bounds, last, result, bounds.size());
+    }
+
+    //! template <class Lexer, class RandomAccessIterator, class OutputIterator, class Char>
+    //! RandomAccessIterator parallel_lex_records(
+    //!     Lexer const& lexer,
+    //!     RandomAccessIterator first, RandomAccessIterator last,
+    //!     OutputIterator result, Char separator)
+    //!
+    //! \effects Equivalent to `return parallel_lex_records(lexer, first,
+    //!  last, result, separator, parallel_options());`.
+    template <
+        typename Lexer, typename RandomAccessIterator,
+        typename OutputIterator, typename Char>
+    RandomAccessIterator parallel_lex_records(
+        Lexer const& lexer,
+        RandomAccessIterator first, RandomAccessIterator last,
+        OutputIterator result, Char separator)
+    {
+        return lexers::parallel_lex_records(
+            lexer, first, last, result, separator, parallel_options());
+    }
+}}
+
+#endif /*EGGS_LEXER_PARALLEL_HPP*/
@@ -0,0 +1,397 @@
+//! \file eggs/lexer/pipeline.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_PIPELINE_HPP
+#define EGGS_LEXER_PIPELINE_HPP
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace eggs { namespace lexers
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Waits for the other side of a queue by spinning for a while, and
+        // then by yielding the processor.
+        class backoff
+        {
+        public:
+            backoff() noexcept
+              : _spins(0)
+            {}
+
+            void operator()() noexcept
+            {
+                if (_spins < 64)
+                {
+                    ++_spins;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+                    __builtin_ia32_pause();
+#endif
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+
+        private:
+            unsigned _spins;
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! class spsc_queue;
+    //!
+    //! Class template `spsc_queue` represents a bounded, lock-free, first-in
+    //! first-out queue for a single producer thread and a single consumer
+    //! thread. A producer that finds the queue full waits for the consumer to
+    //! catch up, which applies backpressure without taking locks.
+    //!
+    //! \requires The type `T` shall satisfy DefaultConstructible and
+    //!  MoveAssignable.
+    template <typename T>
+    class spsc_queue
+    {
+    public:
+        //! explicit spsc_queue(std::size_t capacity);
+        //!
+        //! \effects Initializes an empty, open queue that holds up to
+        //!  `capacity` elements.
+        explicit spsc_queue(std::size_t capacity)
+          : _capacity(capacity != 0 ? capacity : 1)
+          , _slots(new T[_capacity + 1])
+          , _head(0)
+          , _tail(0)
+          , _closed(false)
+          , _cached_head(0)
+          , _cached_tail(0)
+        {}
+
+        spsc_queue(spsc_queue const&) = delete;
+        spsc_queue& operator=(spsc_queue const&) = delete;
+
+        //! std::size_t capacity() const noexcept;
+        //!
+        //! \returns The maximum number of elements in the queue.
+        std::size_t capacity() const noexcept
+        {
+            return _capacity;
+        }
+
+        //! bool try_push(T&& value);
+        //!
+        //! \effects If the queue is not full, moves `value` into the back of
+        //!  the queue.
+        //!
+        //! \returns `true` if `value` was pushed; otherwise, `false`.
+        //!
+        //! \remarks Shall only be called from the producer thread.
+        bool try_push(T&& value)
+        {
+            std::size_t const tail = _tail.load(std::memory_order_relaxed);
+            std::size_t const next = _next(tail);
+            if (next == _cached_head)
+            {
+                _cached_head = _head.load(std::memory_order_acquire);
+                if (next == _cached_head)
+                    return false;
+            }
+
+            _slots[tail] = std::move(value);
+            _tail.store(next, std::memory_order_release);
+            return true;
+        }
+
+        //! void push(T&& value);
+        //!
+        //! \effects Waits until the queue is not full, and then moves `value`
+        //!  into the back of the queue.
+        //!
+        //! \remarks Shall only be called from the producer thread.
+        void push(T&& value)
+        {
+            detail::backoff wait;
+            while (!try_push(std::move(value)))
+                wait();
+        }
+
+        //! void close() noexcept;
+        //!
+        //! \effects Marks the end of the elements to be pushed.
+        //!
+        //! \remarks Shall only be called from the producer thread.
+        void close() noexcept
+        {
+            _closed.store(true, std::memory_order_release);
+        }
+
+        //! bool try_pop(T& value);
+        //!
+        //! \effects If the queue is not empty, moves the front of the queue
+        //!  into `value` and removes it.
+        //!
+        //! \returns `true` if `value` was popped; otherwise, `false`.
+        //!
+        //! \remarks Shall only be called from the consumer thread.
+        bool try_pop(T& value)
+        {
+            std::size_t const head = _head.load(std::memory_order_relaxed);
+            if (head == _cached_tail)
+            {
+                _cached_tail = _tail.load(std::memory_order_acquire);
+                if (head == _cached_tail)
+                    return false;
+            }
+
+            value = std::move(_slots[head]);
+            _head.store(_next(head), std::memory_order_release);
+            return true;
+        }
+
+        //! bool pop(T& value);
+        //!
+        //! \effects Waits until the queue is not empty or it is closed, and
+        //!  then moves the front of the queue, if any, into `value` and
+        //!  removes it.
+        //!
+        //! \returns `true` if `value` was popped; otherwise, `false`, which
+        //!  denotes the queue was closed and all of its elements popped.
+        //!
+        //! \remarks Shall only be called from the consumer thread.
+        bool pop(T& value)
+        {
+            detail::backoff wait;
+            while (!try_pop(value))
+            {
+                if (_closed.load(std::memory_order_acquire))
+                    return try_pop(value);
+                wait();
+            }
+            return true;
+        }
+
+    private:
+        std::size_t _next(std::size_t index) const noexcept
+        {
+            return index != _capacity ? index + 1 : 0;
+        }
+
+    private:
+        std::size_t const _capacity;
+        std::unique_ptr<T[]> const _slots;
+
+        // written by the consumer
+        alignas(64) std::atomic<std::size_t> _head;
+        // written by the producer
+        alignas(64) std::atomic<std::size_t> _tail;
+        std::atomic<bool> _closed;
+
+        // the producer's view of `_head`
+        alignas(64) std::size_t _cached_head;
+        // the consumer's view of `_tail`
+        alignas(64) std::size_t _cached_tail;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer, class Iterator, class Sentinel = Iterator>
+    //! class token_pipeline;
+    //!
+    //! Class template `token_pipeline` represents a lexical analysis running
+    //! on a thread of its own, which hands tokens over in batches through a
+    //! `spsc_queue`, so that lexing overlaps with processing (e.g. parsing)
+    //! of previous tokens on the consuming thread. Batches are recycled once
+    //! consumed.
+    //!
+    //! \requires `Lexer` shall be an instance of `lexer`. The type `Iterator`
+    //!  shall satisfy ForwardIterator. The types `Sentinel` and `Iterator`
+    //!  shall satisfy Sentinel.
+    template <typename Lexer, typename Iterator, typename Sentinel = Iterator>
+    class token_pipeline
+    {
+    public:
+        //! using token = typename Lexer::template token<Iterator, Sentinel>;
+        using token = typename Lexer::template token<Iterator, Sentinel>;
+
+        //! using batch = std::vector<token>;
+        using batch = std::vector<token>;
+
+        //! struct options;
+        //!
+        //! Class `options` holds the parameters of a `token_pipeline`.
+        struct options
+        {
+            //! std::size_t capacity = 8;
+            //!
+            //! The maximum number of batches in flight.
+            std::size_t capacity = 8;
+
+            //! std::size_t batch_size = 1024;
+            //!
+            //! The number of tokens in each batch, but the last one.
+            std::size_t batch_size = 1024;
+        };
+
+    public:
+        //! token_pipeline(Lexer const& lexer, Iterator first, Sentinel last);
+        //!
+        //! \effects Equivalent to `token_pipeline(lexer, first, last,
+        //!  options())`.
+        token_pipeline(Lexer const& lexer, Iterator first, Sentinel last)
+          : token_pipeline(lexer, first, last, options())
+        {}
+
+        //! token_pipeline(Lexer const& lexer, Iterator first, Sentinel last, options const& opts);
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Starts demarcating tokens with `lexer` in the given input
+        //!  range `[first, last)` on a new thread, as if by
+        //!  `lexer(first, last, result)`.
+        //!
+        //! \remarks A `token_pipeline` refers to, but does not own, the lexer
+        //!  it was constructed with.
+        token_pipeline(
+            Lexer const& lexer, Iterator first, Sentinel last,
+            options const& opts)
+          : _batch_size(opts.batch_size != 0 ? opts.batch_size : 1)
+          , _full(opts.capacity)
+          , _empty(opts.capacity + 1)
+          , _last(first)
+          , _stop(false)
+        {
+            _thread = std::thread(
+                &token_pipeline::_produce, this, &lexer, first, last);
+        }
+
+        token_pipeline(token_pipeline const&) = delete;
+        token_pipeline& operator=(token_pipeline const&) = delete;
+
+        //! ~token_pipeline();
+        //!
+        //! \effects Stops lexing, and waits for the thread to finish.
+        ~token_pipeline()
+        {
+            _stop.store(true, std::memory_order_relaxed);
+            _thread.join();
+        }
+
+        //! bool pop(batch& tokens);
+        //!
+        //! \effects Recycles the contents of `tokens`, waits for the next
+        //!  batch of tokens to be demarcated, and then moves it into
+        //!  `tokens`.
+        //!
+        //! \returns `true` if a batch was popped; otherwise, `false`, which
+        //!  denotes all tokens were popped.
+        //!
+        //! \throws Any exception thrown while lexing, once all batches
+        //!  demarcated before it was thrown are popped.
+        //!
+        //! \remarks Shall only be called from a single thread.
+        bool pop(batch& tokens)
+        {
+            if (tokens.capacity() != 0)
+            {
+                tokens.clear();
+                _empty.try_push(std::move(tokens));
+            }
+
+            if (_full.pop(tokens))
+                return true;
+
+            tokens.clear();
+            if (_error)
+                std::rethrow_exception(_error);
+            return false;
+        }
+
+        //! Iterator last() const;
+        //!
+        //! \preconditions `pop` returned `false`.
+        //!
+        //! \returns An iterator denoting the start of the range that produced
+        //!  an invalid token, if one was found; otherwise, an iterator
+        //!  denoting the end of the input range.
+        Iterator last() const
+        {
+            return _last;
+        }
+
+    private:
+        void _produce(Lexer const* lexer, Iterator first, Sentinel last) noexcept
+        {
+            batch tokens;
+            auto const push = [&]() noexcept -> bool
+            {
+                detail::backoff wait;
+                while (!_full.try_push(std::move(tokens)))
+                {
+                    if (_stop.load(std::memory_order_relaxed))
+                        return false;
+                    wait();
+                }
+                return true;
+            };
+            auto const flush = [&]() -> bool
+            {
+                if (!push())
+                    return false;
+
+                if (!_empty.try_pop(tokens))
+                    tokens = batch();
+                tokens.reserve(_batch_size);
+                return true;
+            };
+
+            try
+            {
+                tokens.reserve(_batch_size);
+                while (first != last)
+                {
+                    token t = lexer->tokenize(first, last);
+                    if (t.category() == token::no_category)
+                        break;
+
+                    assert(t.first != t.second && "lexeme cannot be empty");
+                    first = t.second;
+                    tokens.push_back(std::move(t));
+                    if (tokens.size() == _batch_size && !flush())
+                        break;
+                }
+                if (!tokens.empty())
+                    flush();
+            } catch (...) {
+                // deliver the tokens demarcated before the exception
+                if (!tokens.empty())
+                    push();
+                _error = std::current_exception();
+            }
+
+            _last = first;
+            _full.close();
+        }
+
+    private:
+        std::size_t _batch_size;
+        spsc_queue<batch> _full;
+        spsc_queue<batch> _empty;
+        Iterator _last;
+        std::exception_ptr _error;
+        std::atomic<bool> _stop;
+        std::thread _thread;
+    };
+}}
+
+#endif /*EGGS_LEXER_PIPELINE_HPP*/
@@ -0,0 +1,277 @@
+//! \file eggs/lexer/side_table.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_SIDE_TABLE_HPP
+#define EGGS_LEXER_SIDE_TABLE_HPP
+
+#include <eggs/lexer/token.hpp>
+#include <eggs/lexer/tokenize.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eggs { namespace lexers
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class T>
+    //! struct side_ref;
+    //!
+    //! Class template `side_ref` represents the identifier of a value of type
+    //! `T` stored in a `side_table`.
+    template <typename T>
+    struct side_ref
+    {
+        //! std::uint32_t id;
+        //!
+        //! The position of the value among those of type `T` in the table.
+        std::uint32_t id;
+
+        //! friend constexpr bool operator==(side_ref lhs, side_ref rhs) noexcept;
+        friend constexpr bool operator==(side_ref lhs, side_ref rhs) noexcept
+        {
+            return lhs.id == rhs.id;
+        }
+
+        //! friend constexpr bool operator!=(side_ref lhs, side_ref rhs) noexcept;
+        friend constexpr bool operator!=(side_ref lhs, side_ref rhs) noexcept
+        {
+            return lhs.id != rhs.id;
+        }
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! class side_table;
+    //!
+    //! Class `side_table` represents storage for associated values kept out
+    //! of line from their tokens. Values of each type are stored
+    //! contiguously, in the order they were pushed, and are referred to by a
+    //! `side_ref`.
+    //!
+    //! \remarks A `side_table` is not safe to use concurrently.
+    class side_table
+    {
+        struct _column_base
+        {
+            virtual ~_column_base() = default;
+            virtual void clear() noexcept = 0;
+        };
+
+        template <typename T>
+        struct _column
+          : _column_base
+        {
+            std::vector<T> values;
+
+            void clear() noexcept override
+            {
+                values.clear();
+            }
+        };
+
+        template <typename T>
+        static void const* _key() noexcept
+        {
+            static char const key = 0;
+            return &key;
+        }
+
+    public:
+        //! side_table() noexcept;
+        //!
+        //! \effects Initializes an empty table.
+        side_table() noexcept = default;
+
+        side_table(side_table&&) noexcept = default;
+        side_table& operator=(side_table&&) noexcept = default;
+
+        //! template <class T>
+        //! side_ref<std::decay_t<T>> push(T&& value);
+        //!
+        //! \effects Appends `std::forward<T>(value)` to the values of type
+        //!  `std::decay_t<T>`.
+        //!
+        //! \returns The identifier of the appended value.
+        //!
+        //! \throws `std::length_error` if the table already holds `2^32`
+        //!  values of that type.
+        template <typename T>
+        side_ref<std::decay_t<T>> push(T&& value)
+        {
+            std::vector<std::decay_t<T>>& values =
+                _values<std::decay_t<T>>();
+            if (values.size() > std::numeric_limits<std::uint32_t>::max())
+                throw std::length_error("side_table is full");
+
+            values.push_back(std::forward<T>(value));
+            return side_ref<std::decay_t<T>>{
+                std::uint32_t(values.size() - 1)};
+        }
+
+        //! template <class T>
+        //! T& operator[](side_ref<T> ref);
+        //!
+        //! \preconditions `ref` was returned by `push` on `*this`, and the
+        //!  table was not cleared since.
+        //!
+        //! \returns A reference to the value identified by `ref`.
+        template <typename T>
+        T& operator[](side_ref<T> ref)
+        {
+            std::vector<T>* const values = _find<T>();
+            assert(values != nullptr && ref.id < values->size()
+                && "invalid side_ref");
+            return (*values)[ref.id];
+        }
+
+        //! template <class T>
+        //! T const& operator[](side_ref<T> ref) const;
+        //!
+        //! \effects Equivalent to the non-const overload.
+        template <typename T>
+        T const& operator[](side_ref<T> ref) const
+        {
+            std::vector<T> const* const values = _find<T>();
+            assert(values != nullptr && ref.id < values->size()
+                && "invalid side_ref");
+            return (*values)[ref.id];
+        }
+
+        //! template <class T>
+        //! std::size_t size() const noexcept;
+        //!
+        //! \returns The number of values of type `T` in the table.
+        template <typename T>
+        std::size_t size() const noexcept
+        {
+            std::vector<T> const* const values = _find<T>();
+            return values != nullptr ? values->size() : 0;
+        }
+
+        //! void clear() noexcept;
+        //!
+        //! \effects Removes every value from the table, invalidating every
+        //!  `side_ref` to it. Storage is retained for reuse.
+        void clear() noexcept
+        {
+            for (auto& column : _columns)
+                column.second->clear();
+        }
+
+    private:
+        template <typename T>
+        std::vector<T>* _find() const noexcept
+        {
+            void const* const key = _key<T>();
+            for (auto const& column : _columns)
+            {
+                if (column.first == key)
+                    return &static_cast<_column<T>&>(*column.second).values;
+            }
+            return nullptr;
+        }
+
+        template <typename T>
+        std::vector<T>& _values()
+        {
+            if (std::vector<T>* const values = _find<T>())
+                return *values;
+
+            auto column = std::make_unique<_column<T>>();
+            std::vector<T>& values = column->values;
+            _columns.emplace_back(_key<T>(), std::move(column));
+            return values;
+        }
+
+    private:
+        std::vector<std::pair<void const*, std::unique_ptr<_column_base>>>
+            _columns;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Rule, std::size_t Threshold = 16>
+    //! class side_rule;
+    //!
+    //! Class template `side_rule` represents a tokenization rule adaptor
+    //! that demarcates tokens as `Rule` does. Associated values whose size
+    //! exceeds `Threshold` bytes are moved into a `side_table`, and the token
+    //! holds a `side_ref` to them instead; smaller ones are kept inline.
+    //!
+    //! \requires `Rule` shall satisfy TokenizationRule.
+    template <typename Rule, std::size_t Threshold = 16>
+    class side_rule
+    {
+    public:
+        //! explicit side_rule(side_table& table, Rule rule = Rule());
+        //!
+        //! \effects Initializes the adapted rule with `std::move(rule)`, and
+        //!  refers to `table` for the storage of large associated values.
+        explicit side_rule(side_table& table, Rule rule = Rule())
+          : _table(&table)
+          , _rule(std::move(rule))
+        {}
+
+        //! template <class Iterator, class Sentinel>
+        //! decltype(auto) operator()(Iterator first, Sentinel last) const;
+        //!
+        //! \effects Equivalent to `return rule(first, last);`.
+        template <typename Iterator, typename Sentinel>
+        decltype(auto) operator()(Iterator first, Sentinel last) const
+        {
+            return _rule(first, last);
+        }
+
+        //! template <class Iterator, class Payload>
+        //! auto evaluate(token<Iterator, Payload>&& token) const;
+        //!
+        //! \effects Evaluates the associated value `v` of `token` as `Rule`
+        //!  would.
+        //!
+        //! \returns `table.push(std::move(v))` if `sizeof(v)` exceeds
+        //!  `Threshold`; otherwise, `v`.
+        template <typename Iterator, typename Payload>
+        auto evaluate(token<Iterator, Payload>&& token) const
+        {
+            auto const evaluate = [&]() -> decltype(auto)
+            {
+                if constexpr (std::is_void_v<Payload>)
+                {
+                    return detail::evaluate(_rule,
+                        token.category(), token.first, token.second,
+                        detail::empty{});
+                } else {
+                    return detail::evaluate(_rule,
+                        token.category(), token.first, token.second,
+                        std::move(token.value));
+                }
+            };
+
+            using value_type = std::decay_t<decltype(evaluate())>;
+            if constexpr (std::is_void_v<value_type>)
+            {
+                evaluate();
+            } else if constexpr (sizeof(value_type) > Threshold) {
+                return _table->push(evaluate());
+            } else {
+                return value_type(evaluate());
+            }
+        }
+
+    private:
+        side_table* _table;
+        Rule _rule;
+    };
+}}
+
+#endif /*EGGS_LEXER_SIDE_TABLE_HPP*/
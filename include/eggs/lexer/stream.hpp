@@ -0,0 +1,696 @@
+//! \file eggs/lexer/stream.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_STREAM_HPP
+#define EGGS_LEXER_STREAM_HPP
+
+#include <eggs/lexer/token.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <optional>
+#include <streambuf>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eggs { namespace lexers
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // A sentinel for the input available so far, which records whether
+        // it was reached before the input was known to be complete.
+        template <typename Char>
+        struct stream_sentinel
+        {
+            Char const* end;
+            bool* starved;
+            bool final;
+
+            friend bool operator==(
+                Char const* iter, stream_sentinel const& s) noexcept
+            {
+                if (iter != s.end)
+                    return false;
+                if (!s.final)
+                    *s.starved = true;
+                return true;
+            }
+
+            friend bool operator==(
+                stream_sentinel const& s, Char const* iter) noexcept
+            {
+                return iter == s;
+            }
+
+            friend bool operator!=(
+                Char const* iter, stream_sentinel const& s) noexcept
+            {
+                return !(iter == s);
+            }
+
+            friend bool operator!=(
+                stream_sentinel const& s, Char const* iter) noexcept
+            {
+                return !(iter == s);
+            }
+        };
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! enum class stream_status;
+    //!
+    //! Enumeration `stream_status` describes why a streaming lexer did not
+    //! produce a token.
+    enum class stream_status
+    {
+        //! More input is needed to demarcate the next token.
+        suspended,
+
+        //! The input is complete and has been entirely demarcated.
+        exhausted,
+
+        //! The input at the current position produced an invalid token.
+        error
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer, class Char = char>
+    //! class token_generator;
+    //!
+    //! Class template `token_generator` represents a resumable lexical
+    //! analysis over input that is supplied incrementally. Tokens are pulled
+    //! one at a time; when the input supplied so far is not enough to
+    //! demarcate the next token, the generator suspends until more input is
+    //! supplied or the input is declared complete.
+    //!
+    //! \requires `Lexer` shall be an instance of `lexer`.
+    //!
+    //! \remarks A token is considered to be demarcated once none of the
+    //!  tokenization rules reached the end of the input supplied so far while
+    //!  demarcating it. A `token_generator` refers to, but does not own, the
+    //!  lexer it was constructed with.
+    template <typename Lexer, typename Char = char>
+    class token_generator
+    {
+        using _sentinel = detail::stream_sentinel<Char>;
+
+    public:
+        //! using token = typename Lexer::template token<Char const*, Sentinel>;
+        //!
+        //! where `Sentinel` is an unspecified sentinel type for `Char const*`.
+        using token = typename Lexer::template token<Char const*, _sentinel>;
+
+    public:
+        //! explicit token_generator(Lexer const& lexer)
+        //!
+        //! \effects Initializes the generator to demarcate tokens with `lexer`
+        //!  over an initially empty input.
+        explicit token_generator(Lexer const& lexer)
+          : _lexer(&lexer)
+          , _buffer()
+          , _position(0)
+          , _final(false)
+          , _status(stream_status::suspended)
+        {}
+
+        //! void feed(Char const* first, Char const* last)
+        //!
+        //! \requires `finish()` shall not have been called.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Appends the characters in `[first, last)` to the input.
+        //!
+        //! \postconditions Previously produced tokens are invalidated.
+        void feed(Char const* first, Char const* last)
+        {
+            assert(!_final && "cannot feed a finished generator");
+            _buffer.erase(_buffer.begin(), _buffer.begin() + _position);
+            _position = 0;
+            _buffer.insert(_buffer.end(), first, last);
+        }
+
+        //! void finish()
+        //!
+        //! \effects Declares the input complete.
+        void finish() noexcept
+        {
+            _final = true;
+        }
+
+        //! std::optional<token> next()
+        //!
+        //! \effects Demarcates the next token in the input, if possible.
+        //!
+        //! \returns The next token, if one could be demarcated; otherwise,
+        //!  an empty `optional`, in which case `status()` describes why.
+        //!
+        //! \remarks The iterators of the returned token are valid until the
+        //!  next call to `feed`.
+        std::optional<token> next()
+        {
+            Char const* const first = _buffer.data() + _position;
+            bool starved = false;
+            token t = _lexer->tokenize(first,
+                _sentinel{_buffer.data() + _buffer.size(), &starved, _final});
+
+            if (starved)
+            {
+                _status = stream_status::suspended;
+                return std::nullopt;
+            }
+            if (t.category() == token::no_category)
+            {
+                _status = _position == _buffer.size()
+                  ? stream_status::exhausted : stream_status::error;
+                return std::nullopt;
+            }
+
+            assert(t.first != t.second && "lexeme cannot be empty");
+            _position += static_cast<std::size_t>(t.second - t.first);
+            return std::optional<token>(std::move(t));
+        }
+
+        //! stream_status status() const noexcept
+        //!
+        //! \returns The reason why the last call to `next` did not produce a
+        //!  token, or `stream_status::suspended` if there was no such call.
+        stream_status status() const noexcept
+        {
+            return _status;
+        }
+
+        //! Char const* position() const noexcept
+        //!
+        //! \returns A pointer to the start of the input that has not been
+        //!  demarcated yet.
+        //!
+        //! \remarks The returned pointer is valid until the next call to
+        //!  `feed`.
+        Char const* position() const noexcept
+        {
+            return _buffer.data() + _position;
+        }
+
+    private:
+        Lexer const* _lexer;
+        std::vector<Char> _buffer;
+        std::size_t _position;
+        bool _final;
+        stream_status _status;
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer, class Char = char>
+    //! class chunked_lexer;
+    //!
+    //! Class template `chunked_lexer` represents a lexical analysis over input
+    //! that arrives as a sequence of chunks. Tokens that lie within a single
+    //! chunk refer directly into it, while tokens that straddle a chunk
+    //! boundary are stitched together in a carry buffer, so that memory use
+    //! is bounded by the longest token rather than by the whole input.
+    //!
+    //! \requires `Lexer` shall be an instance of `lexer`.
+    //!
+    //! \remarks A token is considered to be demarcated once none of the
+    //!  tokenization rules reached the end of the input supplied so far while
+    //!  demarcating it. A `chunked_lexer` refers to, but does not own, the
+    //!  lexer it was constructed with.
+    template <typename Lexer, typename Char = char>
+    class chunked_lexer
+    {
+        using _sentinel = detail::stream_sentinel<Char>;
+
+    public:
+        //! using token = typename Lexer::template token<Char const*, Sentinel>;
+        //!
+        //! where `Sentinel` is an unspecified sentinel type for `Char const*`.
+        using token = typename Lexer::template token<Char const*, _sentinel>;
+
+    public:
+        //! explicit chunked_lexer(Lexer const& lexer)
+        //!
+        //! \effects Initializes the chunked lexer to demarcate tokens with
+        //!  `lexer` over an initially empty input.
+        explicit chunked_lexer(Lexer const& lexer)
+          : _lexer(&lexer)
+          , _carry()
+          , _retired()
+          , _offset(0)
+          , _status(stream_status::suspended)
+        {}
+
+        //! template <class OutputIterator>
+        //! OutputIterator feed(Char const* first, Char const* last, OutputIterator result)
+        //!
+        //! \requires The type `OutputIterator` shall satisfy OutputIterator.
+        //!  The expression `*result = token{}` shall be valid. `finish()`
+        //!  shall not have been called.
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Appends the chunk `[first, last)` to the input, and copies
+        //!  into `[result, ...)` the tokens that can be demarcated with it,
+        //!  until an invalid token is found or more input is needed.
+        //!
+        //! \returns `result` past the copied tokens.
+        //!
+        //! \postconditions Tokens copied by previous calls to `feed` that
+        //!  straddled a chunk boundary are invalidated.
+        //!
+        //! \remarks Tokens that lie within `[first, last)` refer into it.
+        //!  Only the characters of a token that straddles a chunk boundary
+        //!  are copied, which happens in pieces of geometrically increasing
+        //!  size until the token is demarcated.
+        template <typename OutputIterator>
+        OutputIterator feed(
+            Char const* first, Char const* last,
+            OutputIterator result)
+        {
+            _retired.clear();
+            if (_status == stream_status::error)
+                return result;
+
+            Char const* next = first;
+            if (!_carry.empty())
+            {
+                std::size_t piece = (std::max)(_carry.size(), _min_piece);
+                for (;;)
+                {
+                    Char const* const carry_first = _carry.data();
+                    Char const* const carry_last = carry_first + _carry.size();
+
+                    bool starved = false;
+                    token t = _lexer->tokenize(carry_first,
+                        _sentinel{carry_last, &starved, false});
+                    if (!starved)
+                    {
+                        if (t.category() == token::no_category)
+                        {
+                            _status = stream_status::error;
+                            return result;
+                        }
+
+                        std::size_t const tail =
+                            static_cast<std::size_t>(carry_last - t.second);
+                        std::size_t const stitched =
+                            static_cast<std::size_t>(next - first);
+                        _emit(result, std::move(t));
+
+                        // keep the buffer alive for the token just emitted
+                        if (tail <= stitched)
+                        {
+                            next -= tail;
+                            _retired.push_back(std::move(_carry));
+                            _carry.clear();
+                            break;
+                        }
+
+                        std::vector<Char> rest(carry_last - tail, carry_last);
+                        _retired.push_back(std::move(_carry));
+                        _carry = std::move(rest);
+                        continue;
+                    }
+
+                    if (next == last)
+                        return result;
+
+                    std::size_t const size = (std::min)(
+                        piece, static_cast<std::size_t>(last - next));
+                    _carry.insert(_carry.end(), next, next + size);
+                    next += size;
+                    piece *= 2;
+                }
+            }
+
+            for (;;)
+            {
+                bool starved = false;
+                token t = _lexer->tokenize(next,
+                    _sentinel{last, &starved, false});
+                if (starved)
+                {
+                    _carry.assign(next, last);
+                    return result;
+                }
+                if (t.category() == token::no_category)
+                {
+                    _status = stream_status::error;
+                    return result;
+                }
+
+                next = t.second;
+                _emit(result, std::move(t));
+            }
+        }
+
+        //! template <class OutputIterator>
+        //! OutputIterator finish(OutputIterator result)
+        //!
+        //! \requires The type `OutputIterator` shall satisfy OutputIterator.
+        //!  The expression `*result = token{}` shall be valid. `finish()`
+        //!  shall not have been called.
+        //!
+        //! \effects Declares the input complete, and copies into `[result,
+        //!  ...)` the remaining tokens until an invalid token is found or the
+        //!  input is exhausted.
+        //!
+        //! \returns `result` past the copied tokens.
+        //!
+        //! \postconditions Tokens copied by previous calls to `feed` that
+        //!  straddled a chunk boundary are invalidated.
+        template <typename OutputIterator>
+        OutputIterator finish(OutputIterator result)
+        {
+            _retired.clear();
+            if (_status == stream_status::error)
+                return result;
+
+            Char const* next = _carry.data();
+            Char const* const last = next + _carry.size();
+            for (;;)
+            {
+                token t = _lexer->tokenize(next,
+                    _sentinel{last, nullptr, true});
+                if (t.category() == token::no_category)
+                {
+                    _status = next == last
+                      ? stream_status::exhausted : stream_status::error;
+                    return result;
+                }
+
+                next = t.second;
+                _emit(result, std::move(t));
+            }
+        }
+
+        //! stream_status status() const noexcept
+        //!
+        //! \returns `stream_status::error` if an invalid token was found,
+        //!  `stream_status::exhausted` if `finish()` was called and the input
+        //!  was entirely demarcated, or `stream_status::suspended` otherwise.
+        stream_status status() const noexcept
+        {
+            return _status;
+        }
+
+        //! std::size_t offset() const noexcept
+        //!
+        //! \returns The number of characters in the input demarcated so far.
+        //!  If an invalid token was found, this is the offset where it
+        //!  starts.
+        std::size_t offset() const noexcept
+        {
+            return _offset;
+        }
+
+        //! std::size_t carry_size() const noexcept
+        //!
+        //! \returns The number of characters currently held in the carry
+        //!  buffer.
+        std::size_t carry_size() const noexcept
+        {
+            return _carry.size();
+        }
+
+    private:
+        template <typename OutputIterator>
+        void _emit(OutputIterator& result, token&& t)
+        {
+            assert(t.first != t.second && "lexeme cannot be empty");
+            _offset += static_cast<std::size_t>(t.second - t.first);
+            *result++ = std::move(t);
+        }
+
+    private:
+        static constexpr std::size_t _min_piece = 64;
+
+        Lexer const* _lexer;
+        std::vector<Char> _carry;
+        std::vector<std::vector<Char>> _retired;
+        std::size_t _offset;
+        stream_status _status;
+    };
+
+    template <typename Lexer, typename Char>
+    constexpr std::size_t chunked_lexer<Lexer, Char>::_min_piece;
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class InputIterator, class Sentinel = InputIterator>
+    //! class input_buffer;
+    //!
+    //! Class template `input_buffer` adapts a single-pass input range into a
+    //! range of ForwardIterators, suitable for tokenization rules, by
+    //! buffering the elements read from it. Elements are read only when the
+    //! rules look at them, and are discarded once released, so that the
+    //! buffer grows only up to the longest lookahead needed by the rules.
+    //!
+    //! \requires The type `InputIterator` shall satisfy InputIterator. The
+    //!  types `Sentinel` and `InputIterator` shall satisfy Sentinel.
+    //!
+    //! \remarks An `input_buffer` is neither copyable nor movable, since its
+    //!  iterators refer to it.
+    template <typename InputIterator, typename Sentinel = InputIterator>
+    class input_buffer
+    {
+    public:
+        //! using value_type = typename std::iterator_traits<InputIterator>::value_type;
+        using value_type =
+            typename std::iterator_traits<InputIterator>::value_type;
+
+        class iterator;
+        class sentinel;
+
+    public:
+        //! input_buffer(InputIterator first, Sentinel last)
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Initializes the buffer to read from `[first, last)`. No
+        //!  element is read.
+        input_buffer(InputIterator first, Sentinel last)
+          : _first(std::move(first))
+          , _last(std::move(last))
+          , _data()
+          , _base(0)
+        {}
+
+        //! template <class CharT, class Traits>
+        //! explicit input_buffer(std::basic_streambuf<CharT, Traits>* sb)
+        //!
+        //! \effects Equivalent to `input_buffer(InputIterator(sb),
+        //!  InputIterator())`.
+        //!
+        //! \remarks This constructor shall not participate in overload
+        //!  resolution unless `InputIterator` is `std::istreambuf_iterator<
+        //!  CharT, Traits>`.
+        template <
+            typename CharT, typename Traits,
+            typename Enable = std::enable_if_t<std::is_same_v<
+                InputIterator, std::istreambuf_iterator<CharT, Traits>>>>
+        explicit input_buffer(std::basic_streambuf<CharT, Traits>* sb)
+          : input_buffer(InputIterator(sb), InputIterator())
+        {}
+
+        input_buffer(input_buffer const&) = delete;
+        input_buffer& operator=(input_buffer const&) = delete;
+
+        //! iterator begin() noexcept
+        //!
+        //! \returns An iterator denoting the first element that has not been
+        //!  released.
+        iterator begin() noexcept
+        {
+            return iterator(*this, _base);
+        }
+
+        //! sentinel end() noexcept
+        //!
+        //! \returns A sentinel denoting the end of the input range.
+        sentinel end() noexcept
+        {
+            return sentinel(*this);
+        }
+
+        //! void release(iterator const& pos)
+        //!
+        //! \preconditions `pos` shall be reachable from `begin()`.
+        //!
+        //! \effects Discards the buffered elements before `pos`.
+        //!
+        //! \postconditions `begin() == pos`. Iterators before `pos` are
+        //!  invalidated.
+        void release(iterator const& pos)
+        {
+            assert(pos._buffer == this && pos._offset >= _base);
+            std::size_t const count = (std::min)(
+                pos._offset - _base, _data.size());
+            _data.erase(_data.begin(), _data.begin() + count);
+            _base = pos._offset;
+        }
+
+        //! std::size_t size() const noexcept
+        //!
+        //! \returns The number of elements currently buffered.
+        std::size_t size() const noexcept
+        {
+            return _data.size();
+        }
+
+    private:
+        bool _fill(std::size_t offset)
+        {
+            assert(offset >= _base && "iterator was released");
+            while (offset - _base >= _data.size())
+            {
+                if (_first == _last)
+                    return false;
+                _data.push_back(*_first);
+                ++_first;
+            }
+            return true;
+        }
+
+    private:
+        InputIterator _first;
+        Sentinel _last;
+        std::deque<value_type> _data;
+        std::size_t _base;
+    };
+
+    template <typename CharT, typename Traits>
+    input_buffer(std::basic_streambuf<CharT, Traits>*)
+     -> input_buffer<std::istreambuf_iterator<CharT, Traits>>;
+
+    //! class input_buffer<InputIterator, Sentinel>::iterator;
+    //!
+    //! Class `iterator` is a ForwardIterator over the elements of an
+    //! `input_buffer`, which reads elements from the underlying input range
+    //! on demand.
+    template <typename InputIterator, typename Sentinel>
+    class input_buffer<InputIterator, Sentinel>::iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename input_buffer::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type const*;
+        using reference = value_type const&;
+
+    public:
+        constexpr iterator() noexcept
+          : _buffer(nullptr)
+          , _offset(0)
+        {}
+
+        reference operator*() const
+        {
+            bool const valid = _buffer->_fill(_offset); (void)valid;
+            assert(valid && "cannot dereference end iterator");
+            return _buffer->_data[_offset - _buffer->_base];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        iterator& operator++() noexcept
+        {
+            ++_offset;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        friend bool operator==(iterator const& lhs, iterator const& rhs) noexcept
+        {
+            return lhs._offset == rhs._offset;
+        }
+
+        friend bool operator!=(iterator const& lhs, iterator const& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class input_buffer;
+        friend class sentinel;
+
+        iterator(input_buffer& buffer, std::size_t offset) noexcept
+          : _buffer(&buffer)
+          , _offset(offset)
+        {}
+
+    private:
+        input_buffer* _buffer;
+        std::size_t _offset;
+    };
+
+    //! class input_buffer<InputIterator, Sentinel>::sentinel;
+    //!
+    //! Class `sentinel` denotes the end of the elements of an `input_buffer`.
+    //! Comparing an iterator to it reads an element from the underlying
+    //! input range, if needed.
+    template <typename InputIterator, typename Sentinel>
+    class input_buffer<InputIterator, Sentinel>::sentinel
+    {
+    public:
+        constexpr sentinel() noexcept
+          : _buffer(nullptr)
+        {}
+
+        friend bool operator==(iterator const& lhs, sentinel const& rhs)
+        {
+            return rhs._at_end(lhs);
+        }
+
+        friend bool operator==(sentinel const& lhs, iterator const& rhs)
+        {
+            return rhs == lhs;
+        }
+
+        friend bool operator!=(iterator const& lhs, sentinel const& rhs)
+        {
+            return !(lhs == rhs);
+        }
+
+        friend bool operator!=(sentinel const& lhs, iterator const& rhs)
+        {
+            return !(rhs == lhs);
+        }
+
+    private:
+        friend class input_buffer;
+
+        explicit sentinel(input_buffer& buffer) noexcept
+          : _buffer(&buffer)
+        {}
+
+        bool _at_end(iterator const& iter) const
+        {
+            assert(iter._buffer == _buffer);
+            return !_buffer->_fill(iter._offset);
+        }
+
+    private:
+        input_buffer* _buffer;
+    };
+}}
+
+#endif /*EGGS_LEXER_STREAM_HPP*/
@@ -0,0 +1,210 @@
+//! \file eggs/lexer/token_range.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_TOKEN_RANGE_HPP
+#define EGGS_LEXER_TOKEN_RANGE_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#if __has_include(<version>)
+#include <version>
+#endif
+
+#if __cpp_lib_ranges
+#include <ranges>
+#endif
+
+namespace eggs { namespace lexers
+{
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Lexer, class Iterator, class Sentinel = Iterator>
+    //! class token_range;
+    //!
+    //! Class template `token_range` represents a lazy, single-pass range of
+    //! the tokens demarcated by a lexer in an input range. Each token is
+    //! demarcated when the range iterator is incremented onto it, so that
+    //! tokens are never accumulated.
+    //!
+    //! \requires `Lexer` shall be an instance of `lexer`. The type `Iterator`
+    //!  shall satisfy ForwardIterator. The types `Sentinel` and `Iterator`
+    //!  shall satisfy Sentinel.
+    //!
+    //! \remarks A `token_range` refers to, but does not own, the lexer it was
+    //!  constructed with. It satisfies the requirements of `std::ranges::view`
+    //!  when available.
+    template <typename Lexer, typename Iterator, typename Sentinel = Iterator>
+    class token_range
+#if __cpp_lib_ranges
+      : public std::ranges::view_base
+#endif
+    {
+    public:
+        //! using token = typename Lexer::template token<Iterator, Sentinel>;
+        using token = typename Lexer::template token<Iterator, Sentinel>;
+
+        class iterator;
+
+    public:
+        //! token_range(Lexer const& lexer, Iterator first, Sentinel last)
+        //!
+        //! \preconditions `[first, last)` shall denote a valid range.
+        //!
+        //! \effects Initializes the range to demarcate tokens in the given
+        //!  input range `[first, last)` with `lexer`.
+        token_range(Lexer const& lexer, Iterator first, Sentinel last)
+          : _lexer(&lexer)
+          , _first(first)
+          , _last(last)
+          , _current(token::no_category, first, first)
+        {}
+
+        //! iterator begin()
+        //!
+        //! \effects Demarcates the first token of the range.
+        //!
+        //! \returns An iterator denoting the first token of the range.
+        //!
+        //! \remarks Since the range is single-pass, `begin` shall be called at
+        //!  most once.
+        iterator begin()
+        {
+            _next();
+            return iterator(*this);
+        }
+
+        //! iterator end() const noexcept
+        //!
+        //! \returns An iterator denoting the end of the range.
+        iterator end() const noexcept
+        {
+            return iterator();
+        }
+
+        //! Iterator position() const
+        //!
+        //! \returns An iterator denoting the start of the input range that
+        //!  has not been demarcated yet. Once the range is exhausted, this is
+        //!  the start of the range that produced an invalid token, if one
+        //!  was found; otherwise, the end of the input range.
+        Iterator position() const
+        {
+            return _first;
+        }
+
+    private:
+        void _next()
+        {
+            _current = _lexer->tokenize(_first, _last);
+            if (_current.category() != token::no_category)
+            {
+                assert(_current.first != _current.second && "lexeme cannot be empty");
+                _first = _current.second;
+            }
+        }
+
+    private:
+        Lexer const* _lexer;
+        Iterator _first;
+        Sentinel _last;
+        token _current;
+    };
+
+    //! class token_range<Lexer, Iterator, Sentinel>::iterator;
+    //!
+    //! Class `iterator` is an InputIterator over the tokens of a `token_range`.
+    //! A value-initialized iterator denotes the end of any `token_range`.
+    template <typename Lexer, typename Iterator, typename Sentinel>
+    class token_range<Lexer, Iterator, Sentinel>::iterator
+    {
+        class _postfix_proxy
+        {
+        public:
+            token const& operator*() const noexcept
+            {
+                return _value;
+            }
+
+        private:
+            friend class iterator;
+
+            explicit _postfix_proxy(token const& value)
+              : _value(value)
+            {}
+
+            token _value;
+        };
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = token;
+        using difference_type = std::ptrdiff_t;
+        using pointer = token const*;
+        using reference = token const&;
+
+    public:
+        constexpr iterator() noexcept
+          : _range(nullptr)
+        {}
+
+        reference operator*() const noexcept
+        {
+            assert(!_at_end() && "cannot dereference end iterator");
+            return _range->_current;
+        }
+
+        pointer operator->() const noexcept
+        {
+            return &**this;
+        }
+
+        iterator& operator++()
+        {
+            assert(!_at_end() && "cannot increment end iterator");
+            _range->_next();
+            return *this;
+        }
+
+        _postfix_proxy operator++(int)
+        {
+            _postfix_proxy proxy(**this);
+            ++*this;
+            return proxy;
+        }
+
+        friend bool operator==(iterator const& lhs, iterator const& rhs) noexcept
+        {
+            return lhs._at_end() == rhs._at_end();
+        }
+
+        friend bool operator!=(iterator const& lhs, iterator const& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class token_range;
+
+        explicit iterator(token_range& range) noexcept
+          : _range(&range)
+        {}
+
+        bool _at_end() const noexcept
+        {
+            return _range == nullptr
+                || _range->_current.category() == token::no_category;
+        }
+
+    private:
+        token_range* _range;
+    };
+}}
+
+#endif /*EGGS_LEXER_TOKEN_RANGE_HPP*/
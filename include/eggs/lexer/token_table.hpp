@@ -0,0 +1,304 @@
+//! \file eggs/lexer/token_table.hpp
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef EGGS_LEXER_TOKEN_TABLE_HPP
+#define EGGS_LEXER_TOKEN_TABLE_HPP
+
+#include <eggs/lexer/token.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eggs { namespace lexers
+{
+    namespace detail
+    {
+        ///////////////////////////////////////////////////////////////////////
+        template <typename Value>
+        class token_table_values
+        {
+        public:
+            //! std::vector<Value> const& values() const noexcept; // only if `Value` is not `void`
+            //!
+            //! \returns The column of associated values.
+            std::vector<Value> const& values() const noexcept
+            {
+                return _values;
+            }
+
+        protected:
+            std::vector<Value> _values;
+        };
+
+        template <>
+        class token_table_values<void>
+        {};
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    //! template <class Iterator, class Value = void>
+    //! class token_table;
+    //!
+    //! Class template `token_table` represents a sequence of tokens stored as
+    //! a structure of arrays: categories, offsets from the start of the
+    //! input, lengths and associated values (if any) each live in a separate
+    //! contiguous column, so that a pass that only looks at one of them scans
+    //! tightly packed memory. Each row can still be viewed as a
+    //! `token<Iterator, Value>`.
+    //!
+    //! \requires The type `Iterator` shall satisfy ForwardIterator.
+    template <typename Iterator, typename Value = void>
+    class token_table
+      : public detail::token_table_values<Value>
+    {
+    public:
+        //! using token = lexers::token<Iterator, Value>;
+        using token = lexers::token<Iterator, Value>;
+
+        //! using category_type = std::uint32_t;
+        using category_type = std::uint32_t;
+
+        //! static constexpr category_type no_category = category_type(-1);
+        //!
+        //! The representation of `token::no_category` in the category column.
+        static constexpr category_type no_category = category_type(-1);
+
+        class iterator;
+
+    public:
+        //! explicit token_table(Iterator base);
+        //!
+        //! \effects Initializes an empty table whose offsets are relative to
+        //!  `base`.
+        explicit token_table(Iterator base)
+          : _base(base)
+        {}
+
+        //! Iterator base() const;
+        //!
+        //! \returns The iterator offsets are relative to.
+        Iterator base() const
+        {
+            return _base;
+        }
+
+        //! std::size_t size() const noexcept;
+        //!
+        //! \returns The number of rows in the table.
+        std::size_t size() const noexcept
+        {
+            return _categories.size();
+        }
+
+        //! bool empty() const noexcept;
+        //!
+        //! \returns `size() == 0`.
+        bool empty() const noexcept
+        {
+            return _categories.empty();
+        }
+
+        //! void reserve(std::size_t n);
+        //!
+        //! \effects Reserves storage for `n` rows in each column.
+        void reserve(std::size_t n)
+        {
+            _categories.reserve(n);
+            _offsets.reserve(n);
+            _lengths.reserve(n);
+            if constexpr (!std::is_void_v<Value>)
+                this->_values.reserve(n);
+        }
+
+        //! void clear() noexcept;
+        //!
+        //! \effects Removes every row from the table.
+        void clear() noexcept
+        {
+            _categories.clear();
+            _offsets.clear();
+            _lengths.clear();
+            if constexpr (!std::is_void_v<Value>)
+                this->_values.clear();
+        }
+
+        //! template <class ...Args>
+        //! void emplace_back(std::size_t category, std::size_t offset, std::size_t length, Args&&... args);
+        //!
+        //! \preconditions `category < no_category ||
+        //!  category == token::no_category`.
+        //!
+        //! \effects Appends a row with the given category, offset and length,
+        //!  and whose associated value (if any) is initialized from the given
+        //!  arguments.
+        //!
+        //! \remarks This function shall not participate in overload
+        //!  resolution unless `std::is_constructible_v<Value, Args...>` is
+        //!  `true`, or `Value` is `void` and `sizeof...(Args)` is zero.
+        template <
+            typename ...Args, typename Enable = std::enable_if_t<
+                std::is_void_v<Value>
+                  ? sizeof...(Args) == 0
+                  : std::is_constructible_v<Value, Args...>>>
+        void emplace_back(
+            std::size_t category, std::size_t offset, std::size_t length,
+            Args&&... args)
+        {
+            assert((category < no_category || category == token::no_category)
+                && "category cannot be represented");
+
+            if constexpr (!std::is_void_v<Value>)
+                this->_values.emplace_back(std::forward<Args>(args)...);
+            _categories.push_back(category_type(category));
+            _offsets.push_back(offset);
+            _lengths.push_back(length);
+        }
+
+        //! std::vector<category_type> const& categories() const noexcept;
+        //!
+        //! \returns The column of categories.
+        std::vector<category_type> const& categories() const noexcept
+        {
+            return _categories;
+        }
+
+        //! std::vector<std::size_t> const& offsets() const noexcept;
+        //!
+        //! \returns The column of offsets, relative to `base()`.
+        std::vector<std::size_t> const& offsets() const noexcept
+        {
+            return _offsets;
+        }
+
+        //! std::vector<std::size_t> const& lengths() const noexcept;
+        //!
+        //! \returns The column of lengths.
+        std::vector<std::size_t> const& lengths() const noexcept
+        {
+            return _lengths;
+        }
+
+        //! token operator[](std::size_t i) const;
+        //!
+        //! \preconditions `i < size()`.
+        //!
+        //! \returns A token whose category, lexeme and associated value (if
+        //!  any) are those of the `i`-th row.
+        //!
+        //! \remarks Constant time if `Iterator` satisfies
+        //!  RandomAccessIterator; otherwise, linear in the offset of the row.
+        token operator[](std::size_t i) const
+        {
+            assert(i < size() && "index out of range");
+
+            using difference_type =
+                typename std::iterator_traits<Iterator>::difference_type;
+
+            std::size_t const category = _categories[i] != no_category
+              ? std::size_t(_categories[i]) : token::no_category;
+            Iterator const first =
+                std::next(_base, difference_type(_offsets[i]));
+            Iterator const last =
+                std::next(first, difference_type(_lengths[i]));
+            if constexpr (!std::is_void_v<Value>)
+                return token(category, first, last, this->_values[i]);
+            else
+                return token(category, first, last);
+        }
+
+        //! iterator begin() const noexcept;
+        //!
+        //! \returns An iterator denoting the first row of the table.
+        iterator begin() const noexcept
+        {
+            return iterator(*this, 0);
+        }
+
+        //! iterator end() const noexcept;
+        //!
+        //! \returns An iterator denoting the end of the table.
+        iterator end() const noexcept
+        {
+            return iterator(*this, size());
+        }
+
+    private:
+        Iterator _base;
+        std::vector<category_type> _categories;
+        std::vector<std::size_t> _offsets;
+        std::vector<std::size_t> _lengths;
+    };
+
+    //! class token_table<Iterator, Value>::iterator;
+    //!
+    //! Class `iterator` is an InputIterator over the rows of a `token_table`,
+    //! each viewed as a `token`.
+    template <typename Iterator, typename Value>
+    class token_table<Iterator, Value>::iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = token;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = token;
+
+    public:
+        constexpr iterator() noexcept
+          : _table(nullptr)
+          , _index(0)
+        {}
+
+        reference operator*() const
+        {
+            return (*_table)[_index];
+        }
+
+        iterator& operator++() noexcept
+        {
+            ++_index;
+            return *this;
+        }
+
+        iterator operator++(int) noexcept
+        {
+            iterator copy = *this;
+            ++_index;
+            return copy;
+        }
+
+        friend bool operator==(iterator const& lhs, iterator const& rhs) noexcept
+        {
+            return lhs._index == rhs._index;
+        }
+
+        friend bool operator!=(iterator const& lhs, iterator const& rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+
+    private:
+        friend class token_table;
+
+        iterator(token_table const& table, std::size_t index) noexcept
+          : _table(&table)
+          , _index(index)
+        {}
+
+    private:
+        token_table const* _table;
+        std::size_t _index;
+    };
+}}
+
+#endif /*EGGS_LEXER_TOKEN_TABLE_HPP*/
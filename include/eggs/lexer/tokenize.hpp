@@ -359,18 +359,65 @@ namespace eggs { namespace lexers
             }
         };
 
+        template <typename Iterator, typename Visitor>
+        struct visit_token
+        {
+            Iterator first, last;
+            Visitor& visitor;
+
+            template <std::size_t I, typename Ri>
+            void operator()(
+                index<I> category,
+                intermediate_state<Ri>& /*match*/) const
+            {
+                visitor(category, first, last);
+            }
+
+            template <std::size_t I, typename Ri, typename Pi>
+            void operator()(
+                index<I> category,
+                intermediate_state<Ri, Pi>& match) const
+            {
+                detail::evaluate(match.rule, I, first, last,
+                    std::move(match.payload));
+                visitor(category, first, last);
+            }
+
+            template <std::size_t I, typename Ri, typename Pi, typename Vi>
+            void operator()(
+                index<I> category,
+                intermediate_state<Ri, Pi, Vi>& match) const
+            {
+                visitor(category, first, last,
+                    detail::evaluate(match.rule, I, first, last,
+                        std::move(match.payload)));
+            }
+        };
+
+        ///////////////////////////////////////////////////////////////////////
+        template <typename Iterator, typename Intermediate>
+        struct match_result
+        {
+            Iterator mark;
+            Intermediate state;
+
+            std::size_t category() const noexcept
+            {
+                return state.index() - 1;
+            }
+        };
+
         template <
-            typename Value,
             typename Iterator, typename Sentinel,
             std::size_t ...Is, typename ...Rules>
-        token<Iterator, Value> _tokenize(
+        match_result<Iterator, typename detail::tokenization_value<
+            Iterator, Sentinel, Rules...>::intermediate> _match(
             Iterator first, Sentinel last,
             std::index_sequence<Is...>, Rules const&... rules)
         {
-            Iterator mark_iter = first;
+            match_result<Iterator, typename detail::tokenization_value<
+                Iterator, Sentinel, Rules...>::intermediate> match{first, {}};
             std::size_t mark_length = 0;
-            typename detail::tokenization_value<
-                Iterator, Sentinel, Rules...>::intermediate mark_category;
             auto&& lambda = [&](auto category, auto const& rule)
             {
                 constexpr std::size_t I = decltype(category)::value;
@@ -381,18 +428,45 @@ namespace eggs { namespace lexers
                 std::size_t const length = std::distance(first, iter);
                 if (length > mark_length)
                 {
-                    mark_iter = iter;
+                    match.mark = iter;
                     mark_length = length;
-                    mark_category.template emplace<I + 1>(
+                    match.state.template emplace<I + 1>(
                         rule, detail::get_value<Iterator>(result));
                 }
                 return 0;
             }; detail::_swallow_pack({lambda(index<Is>{}, rules)...});
 
-            std::size_t const category = mark_category.index() - 1;
+            return match;
+        }
+
+        template <
+            typename Iterator, typename Intermediate,
+            typename Visitor, std::size_t ...Is>
+        void _visit_match(
+            Iterator first, match_result<Iterator, Intermediate>& match,
+            Visitor& visitor, std::index_sequence<Is...>)
+        {
+            visit_token<Iterator, Visitor> const visit{
+                first, match.mark, visitor};
+            std::size_t const category = match.category();
+            (void)((category == Is && (visit(
+                index<Is>{}, *std::get_if<Is + 1>(&match.state)), true))
+              || ...);
+        }
+
+        template <
+            typename Value,
+            typename Iterator, typename Sentinel,
+            std::size_t ...Is, typename ...Rules>
+        token<Iterator, Value> _tokenize(
+            Iterator first, Sentinel last,
+            std::index_sequence<Is...> is, Rules const&... rules)
+        {
+            auto match = detail::_match(first, last, is, rules...);
+
             return std::visit(
-                make_token<Iterator, Value>{category, first, mark_iter},
-                mark_category);
+                make_token<Iterator, Value>{match.category(), first, match.mark},
+                match.state);
         }
     }
 
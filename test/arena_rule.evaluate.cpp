@@ -0,0 +1,138 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/arena.hpp>
+#include <eggs/lexer/lexer.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+// a word whose value is a copy of its lexeme
+struct word_string
+{
+    template <typename I, typename S>
+    std::pair<I, std::string> operator()(I first, S last) const
+    {
+        I const mark = word{}(first, last);
+        return std::make_pair(mark, std::string(first, mark));
+    }
+};
+
+TEST_CASE("value_arena", "[value_arena]")
+{
+    eggs::lexers::value_arena arena(64);
+    CHECK(arena.bytes_allocated() == 0);
+
+    std::vector<void*> blocks;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        void* const p = arena.allocate(24, 8);
+        CHECK(reinterpret_cast<std::uintptr_t>(p) % 8 == 0);
+        blocks.push_back(p);
+    }
+    CHECK(arena.bytes_allocated() == 24000);
+
+    void* const aligned = arena.allocate(1, 64);
+    CHECK(reinterpret_cast<std::uintptr_t>(aligned) % 64 == 0);
+
+    void* const large = arena.allocate(1 << 20, 16);
+    CHECK(large != nullptr);
+
+    arena.deallocate(large, 1 << 20, 16);
+    arena.release();
+    CHECK(arena.bytes_allocated() == 0);
+
+    CHECK(arena.allocate(8, 8) != nullptr);
+    CHECK(arena.bytes_allocated() == 8);
+}
+
+TEST_CASE("arena_rule<Rule, T>::evaluate(token<Iterator, Payload>&&)", "[arena_rule.evaluate]")
+{
+    eggs::lexers::value_arena arena;
+
+    // constructed in the arena
+    {
+        using rule = eggs::lexers::arena_rule<word_string, std::pmr::string>;
+        eggs::lexers::lexer<rule, punct> l(rule(arena), punct{});
+        using token = decltype(l)::token<char const*>;
+
+        static_assert(std::is_same_v<token::value_type,
+            std::variant<std::monostate, std::pmr::string*>>);
+        static_assert(std::is_trivially_destructible_v<token>);
+
+        std::string const input =
+            "alongenoughwordtoneedanallocation!anotherlongenoughword";
+        std::vector<token> tokens;
+        l(input.data(), input.data() + input.size(),
+            std::back_inserter(tokens));
+
+        REQUIRE(tokens.size() == 3);
+        std::pmr::string const* const first =
+            std::get<std::pmr::string*>(tokens[0].value);
+        CHECK(*first == "alongenoughwordtoneedanallocation");
+        CHECK(tokens[1].value.index() == 0);
+        CHECK(*std::get<std::pmr::string*>(tokens[2].value)
+            == "anotherlongenoughword");
+
+        CHECK(first->get_allocator().resource() == &arena);
+        CHECK(arena.bytes_allocated() >=
+            2 * sizeof(std::pmr::string) + 33 + 21);
+
+        arena.release();
+        CHECK(arena.bytes_allocated() == 0);
+    }
+
+    // of the rule's own value type
+    {
+        using rule = eggs::lexers::arena_rule<number_with_value<int>>;
+        eggs::lexers::lexer<rule> l(rule(arena, number_with_value<int>{42}));
+        using token = decltype(l)::token<char const*>;
+
+        static_assert(std::is_same_v<token::value_type, int*>);
+
+        std::string const input = "123";
+        auto const t = l.tokenize(input.data(), input.data() + input.size());
+        REQUIRE(t.value != nullptr);
+        CHECK(*t.value == 42);
+        CHECK(arena.bytes_allocated() == sizeof(int));
+    }
+
+    // from an evaluate hook
+    {
+        using rule = eggs::lexers::arena_rule<rule_with_evaluate<number, long>>;
+        eggs::lexers::lexer<rule> l(
+            rule(arena, rule_with_evaluate<number, long>{7}));
+
+        std::string const input = "123";
+        auto const t = l.tokenize(input.data(), input.data() + input.size());
+        REQUIRE(t.value != nullptr);
+        CHECK(*t.value == 7);
+    }
+
+    // any memory resource
+    {
+        std::pmr::monotonic_buffer_resource resource;
+        using rule = eggs::lexers::arena_rule<word_string, std::pmr::string>;
+        eggs::lexers::lexer<rule> l{rule(resource)};
+
+        std::string const input = "alongenoughwordtoneedanallocation";
+        auto const t = l.tokenize(input.data(), input.data() + input.size());
+        REQUIRE(t.value != nullptr);
+        CHECK(*t.value == "alongenoughwordtoneedanallocation");
+        CHECK(t.value->get_allocator().resource() == &resource);
+    }
+}
@@ -0,0 +1,67 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/char_set.hpp>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+TEST_CASE("char_set::char_set()", "[char_set.cnstr]")
+{
+    eggs::lexers::char_set const cs;
+
+    CHECK(cs.empty());
+    CHECK(cs.size() == 0u);
+    CHECK(!cs.contains('a'));
+    CHECK(!cs.contains('\0'));
+
+    // constexpr
+    {
+        constexpr eggs::lexers::char_set cs;
+
+        static_assert(cs.empty());
+    }
+}
+
+TEST_CASE("char_set::char_set(char const*)", "[char_set.cnstr]")
+{
+    eggs::lexers::char_set const cs = "\"'\xff";
+
+    CHECK(!cs.empty());
+    CHECK(cs.size() == 3u);
+    CHECK(cs.contains('"'));
+    CHECK(cs.contains('\''));
+    CHECK(cs.contains('\xff'));
+    CHECK(!cs.contains('a'));
+    CHECK(cs.front() == '"');
+
+    // constexpr
+    {
+        constexpr eggs::lexers::char_set cs = "ab";
+
+        static_assert(cs.size() == 2u);
+        static_assert(cs.contains('a'));
+        static_assert(!cs.contains('c'));
+    }
+}
+
+TEST_CASE("char_set::insert(char, char)", "[char_set.cnstr]")
+{
+    eggs::lexers::char_set cs;
+    cs.insert('0', '9').insert('_');
+
+    CHECK(cs.size() == 11u);
+    CHECK(cs.contains('0'));
+    CHECK(cs.contains('9'));
+    CHECK(cs.contains('_'));
+    CHECK(!cs.contains('a'));
+
+    eggs::lexers::char_set const ab = eggs::lexers::char_set("a") | "b";
+    CHECK(ab.size() == 2u);
+    CHECK(ab.contains('a'));
+    CHECK(ab.contains('b'));
+}
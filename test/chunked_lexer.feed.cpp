@@ -0,0 +1,103 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/stream.hpp>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct lexeme
+{
+    std::size_t category;
+    std::string text;
+
+    template <typename Token>
+    lexeme(Token const& t)
+      : category(t.category())
+      , text(t.first, t.second)
+    {}
+
+    friend bool operator==(lexeme const& lhs, lexeme const& rhs)
+    {
+        return lhs.category == rhs.category && lhs.text == rhs.text;
+    }
+};
+
+TEST_CASE("chunked_lexer<Lexer>::feed(Char const*, Char const*, OutputIterator)", "[chunked_lexer.feed]")
+{
+    using eggs::lexers::stream_status;
+
+    std::string input;
+    for (int i = 0; i < 200; ++i)
+        input += std::to_string(i * 7919) + "abc!" + std::string(i % 97, 'x') + "?";
+
+    eggs::lexers::lexer<number, word, punct> l;
+
+    std::vector<lexeme> expected;
+    auto const last = l(
+        input.data(), input.data() + input.size(),
+        std::back_inserter(expected));
+    REQUIRE(last == input.data() + input.size());
+
+    for (std::size_t chunk_size : {1u, 2u, 3u, 7u, 64u, 1000u, 100000u})
+    {
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+
+        std::vector<lexeme> ts;
+        std::size_t max_carry = 0;
+        for (std::size_t i = 0; i < input.size(); i += chunk_size)
+        {
+            // chunks are transient
+            std::string const chunk = input.substr(i, chunk_size);
+            cl.feed(chunk.data(), chunk.data() + chunk.size(),
+                std::back_inserter(ts));
+            CHECK(cl.status() == stream_status::suspended);
+            if (cl.carry_size() > max_carry)
+                max_carry = cl.carry_size();
+        }
+        cl.finish(std::back_inserter(ts));
+
+        CHECK(cl.status() == stream_status::exhausted);
+        CHECK(cl.offset() == input.size());
+        CHECK(ts == expected);
+        CHECK(max_carry <= 2 * (96 + 4) + 64);
+    }
+
+    // invalid match
+    {
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+
+        char const first[] = "123ab";
+        char const second[] = "c !12";
+
+        std::vector<lexeme> ts;
+        cl.feed(first + 0, first + sizeof(first) - 1, std::back_inserter(ts));
+        CHECK(ts.size() == 0u);
+        cl.feed(second + 0, second + sizeof(second) - 1, std::back_inserter(ts));
+        CHECK(cl.status() == stream_status::error);
+        CHECK(cl.offset() == 6u);
+        REQUIRE(ts.size() == 1u);
+        CHECK(ts[0].text == "123abc");
+    }
+
+    // empty input
+    {
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+
+        std::vector<lexeme> ts;
+        cl.finish(std::back_inserter(ts));
+
+        CHECK(cl.status() == stream_status::exhausted);
+        CHECK(ts.size() == 0u);
+    }
+}
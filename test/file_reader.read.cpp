@@ -0,0 +1,124 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/file_reader.hpp>
+#include <eggs/lexer/lexer.hpp>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+#include "temporary_file.hpp"
+
+namespace
+{
+    void check_read(eggs::lexers::file_reader& reader)
+    {
+        std::vector<std::string> contents;
+        for (std::size_t i = 0; i < 20; ++i)
+        {
+            std::string text;
+            for (std::size_t j = 0; j < i * 1000; ++j)
+                text += std::to_string(j) + "abc!";
+            contents.push_back(text);
+        }
+
+        std::vector<std::unique_ptr<temporary_file>> files;
+        std::vector<std::string> paths;
+        for (std::size_t i = 0; i < contents.size(); ++i)
+        {
+            files.emplace_back(new temporary_file(
+                "file_reader.read." + std::to_string(i) + ".tmp", contents[i]));
+            paths.push_back(files.back()->path);
+        }
+
+        eggs::lexers::lexer<number, word, punct> l;
+
+        std::vector<std::string> results(paths.size());
+        std::vector<std::size_t> counts(paths.size());
+        std::vector<int> calls(paths.size());
+        reader.read(paths.begin(), paths.end(),
+            [&](std::size_t index, char const* first, char const* last)
+            {
+                results[index].assign(first, last);
+                counts[index] = l.count(first, last).counts[2];
+                ++calls[index];
+            });
+
+        for (std::size_t i = 0; i < contents.size(); ++i)
+        {
+            CHECK(calls[i] == 1);
+            CHECK(results[i] == contents[i]);
+            CHECK(counts[i] == i * 1000);
+        }
+
+        // no such file
+        {
+            std::vector<std::string> missing = paths;
+            missing[7] = "file_reader.read.missing.tmp";
+
+            CHECK_THROWS_AS(
+                reader.read(missing.begin(), missing.end(),
+                    [](std::size_t, char const*, char const*) {}),
+                std::system_error const&);
+        }
+
+        // exception
+        {
+            std::size_t calls = 0;
+            CHECK_THROWS_AS(
+                reader.read(paths.begin(), paths.end(),
+                    [&](std::size_t, char const*, char const*)
+                    {
+                        if (++calls == 3)
+                            throw std::runtime_error("stop");
+                    }),
+                std::runtime_error const&);
+            CHECK(calls == 3u);
+        }
+
+        // empty
+        {
+            char const* const none[] = {"file_reader.read.missing.tmp"};
+
+            bool called = false;
+            reader.read(none, none,
+                [&](std::size_t, char const*, char const*) { called = true; });
+            CHECK_FALSE(called);
+        }
+    }
+}
+
+TEST_CASE("file_reader::read(ForwardIterator, ForwardIterator, F&&)", "[file_reader.read]")
+{
+#if EGGS_LEXER_HAS_IO_URING
+    // io_uring, if available
+    {
+        eggs::lexers::file_reader::options opts;
+        opts.depth = 4;
+        eggs::lexers::file_reader reader(opts);
+
+        check_read(reader);
+    }
+#endif
+
+    // threads
+    {
+        eggs::lexers::file_reader::options opts;
+        opts.depth = 4;
+        opts.io_uring = false;
+        eggs::lexers::file_reader reader(opts);
+
+        CHECK_FALSE(reader.uses_io_uring());
+        check_read(reader);
+    }
+}
@@ -0,0 +1,83 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/stream.hpp>
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("input_buffer<InputIterator, Sentinel>::iterator", "[input_buffer.iterator]")
+{
+    std::istringstream is("abc");
+    eggs::lexers::input_buffer in(is.rdbuf());
+
+    auto const first = in.begin();
+    CHECK(in.size() == 0u);
+    CHECK(first != in.end());
+    CHECK(in.size() == 1u);
+    CHECK(*first == 'a');
+
+    // multi-pass
+    auto iter = first;
+    CHECK(*++iter == 'b');
+    CHECK(*first == 'a');
+    CHECK(std::distance(first, iter) == 1);
+
+    ++iter;
+    ++iter;
+    CHECK(iter == in.end());
+    CHECK(in.size() == 3u);
+
+    in.release(iter);
+    CHECK(in.size() == 0u);
+    CHECK(in.begin() == iter);
+    CHECK(in.begin() == in.end());
+}
+
+TEST_CASE("lexer<Rules...>::tokenize(input_buffer::iterator, input_buffer::sentinel)", "[input_buffer.iterator]")
+{
+    std::string input;
+    for (int i = 0; i < 1000; ++i)
+        input += std::to_string(i) + "abc!";
+
+    eggs::lexers::lexer<number, word, punct> l;
+
+    std::vector<std::string> expected;
+    {
+        char const* const first = input.data();
+        char const* const last = first + input.size();
+
+        std::vector<eggs::lexers::token<char const*>> ts;
+        l(first, last, std::back_inserter(ts));
+        for (auto const& t : ts)
+            expected.emplace_back(t.first, t.second);
+    }
+
+    std::istringstream is(input);
+    eggs::lexers::input_buffer in(is.rdbuf());
+
+    std::vector<std::string> ts;
+    std::size_t max_size = 0;
+    for (auto const& t : l.tokens(in.begin(), in.end()))
+    {
+        ts.emplace_back(t.first, t.second);
+        if (in.size() > max_size)
+            max_size = in.size();
+        in.release(t.second);
+    }
+
+    CHECK(ts == expected);
+    CHECK(max_size <= 8u);
+    CHECK(in.begin() == in.end());
+}
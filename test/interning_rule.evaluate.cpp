@@ -0,0 +1,165 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/intern.hpp>
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/parallel.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <map>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("hashing_iterator<Iterator>", "[hashing_iterator]")
+{
+    using eggs::lexers::hashing_iterator;
+    using eggs::lexers::intern_table;
+
+    std::string const input = "abc def";
+    hashing_iterator<char const*> const first(input.data());
+    CHECK(first.hash() == intern_table::hash(""));
+
+    hashing_iterator<char const*> mark = first;
+    ++mark;
+    hashing_iterator<char const*> const copy = mark++;
+    ++mark;
+    CHECK(*mark == ' ');
+    CHECK(mark.base() == input.data() + 3);
+    CHECK(mark.hash() == intern_table::hash("abc"));
+    CHECK(copy.hash() == intern_table::hash("a"));
+    CHECK(copy != mark);
+
+    static_assert(intern_table::hash("abc") != intern_table::hash("abd"));
+}
+
+TEST_CASE("intern_table", "[intern_table]")
+{
+    eggs::lexers::intern_table table;
+
+    auto const a = table.intern("abc");
+    auto const b = table.intern("def");
+    CHECK(a.id == 0);
+    CHECK(b.id == 1);
+    CHECK(table.intern(std::string("abc")) == a);
+    CHECK(table.size() == 2);
+    CHECK(table.name(a) == "abc");
+    CHECK(table.name(b) == "def");
+
+    // long enough to not fit in a small string
+    std::string const long_name(100, 'x');
+    auto const c = table.intern(long_name);
+    for (std::size_t i = 0; i < 1000; ++i)
+        table.intern(std::to_string(i));
+    CHECK(table.name(c) == long_name);
+    CHECK(table.intern(long_name) == c);
+}
+
+TEST_CASE("interning_rule<Rule, Table>::evaluate(token<Iterator, std::uint64_t>&&)", "[interning_rule.evaluate]")
+{
+    using eggs::lexers::symbol;
+
+    // sequential
+    {
+        eggs::lexers::intern_table table;
+        using rule = eggs::lexers::interning_rule<word>;
+        eggs::lexers::lexer<rule, punct> l(rule(table), punct{});
+        using token = decltype(l)::token<char const*>;
+
+        static_assert(std::is_same_v<
+            token::value_type, std::variant<std::monostate, symbol>>);
+
+        std::string const input = "foo!bar!foo!baz";
+        std::vector<token> tokens;
+        l(input.data(), input.data() + input.size(),
+            std::back_inserter(tokens));
+
+        REQUIRE(tokens.size() == 7);
+        symbol const foo = std::get<symbol>(tokens[0].value);
+        symbol const bar = std::get<symbol>(tokens[2].value);
+        CHECK(std::get<symbol>(tokens[4].value) == foo);
+        CHECK(foo != bar);
+        CHECK(table.name(foo) == "foo");
+        CHECK(table.name(bar) == "bar");
+        CHECK(table.name(std::get<symbol>(tokens[6].value)) == "baz");
+        CHECK(table.size() == 3);
+    }
+
+    // only the winning lexeme is interned
+    {
+        eggs::lexers::intern_table table;
+        using rule = eggs::lexers::interning_rule<number>;
+        eggs::lexers::lexer<rule, word> l(rule(table), word{});
+
+        std::string const input = "123abc";
+        auto const t = l.tokenize(input.data(), input.data() + input.size());
+        CHECK(t.category() == 1);
+        CHECK(table.size() == 0);
+    }
+
+    // forward iterators
+    {
+        eggs::lexers::intern_table table;
+        using rule = eggs::lexers::interning_rule<word>;
+        eggs::lexers::lexer<rule> l{rule(table)};
+
+        std::string const text = "abc";
+        std::list<char> const input(text.begin(), text.end());
+        auto const t = l.tokenize(input.begin(), input.end());
+        CHECK(t.second == input.end());
+        CHECK(table.name(t.value) == "abc");
+        CHECK(table.intern("abc") == t.value);
+    }
+
+    // concurrent
+    {
+        eggs::lexers::concurrent_intern_table table;
+        using rule = eggs::lexers::interning_rule<
+            word, eggs::lexers::concurrent_intern_table>;
+        eggs::lexers::lexer<rule, punct> l(rule(table), punct{});
+        using token = decltype(l)::token<char const*>;
+
+        std::string input;
+        for (std::size_t i = 0; i < 50000; ++i)
+            input += "id" + std::to_string(i % 1000) + "!";
+
+        eggs::lexers::parallel_options opts;
+        opts.threads = 4;
+        opts.min_chunk_size = 4096;
+
+        std::vector<token> tokens;
+        char const* const first = input.data();
+        eggs::lexers::parallel_lex_into(l, first, first + input.size(),
+            tokens, opts);
+        REQUIRE(tokens.size() == 100000);
+
+        std::map<std::string_view, std::uint32_t> ids;
+        bool ok = true;
+        for (token const& t : tokens)
+        {
+            if (symbol const* sym = std::get_if<symbol>(&t.value))
+            {
+                std::string_view const lexeme(t.first, t.second - t.first);
+                ok = ok && table.name(*sym) == lexeme;
+                auto const result = ids.emplace(lexeme, sym->id);
+                ok = ok && result.first->second == sym->id;
+            }
+        }
+        CHECK(ok);
+        CHECK(ids.size() == 1000);
+        CHECK(table.size() == 1000);
+        CHECK(table.intern("id42") == symbol{ids["id42"]});
+    }
+}
@@ -0,0 +1,117 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct throwing_evaluate
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        return number{}(first, last);
+    }
+
+    template <typename I>
+    int evaluate(eggs::lexers::token<I>&& /*token*/) const
+    {
+        throw 0;
+    }
+};
+
+TEST_CASE("lexer<Rules...>::count(Iterator, Sentinel)", "[lexer.count]")
+{
+    char const input[] = "123abc!12!";
+
+    eggs::lexers::lexer<number, word, punct> l;
+
+    auto const r = l.count(
+        input + 0, input + sizeof(input) - 1);
+
+    CHECK(r.last == input + 10);
+    REQUIRE(r.counts.size() == 3u);
+    CHECK(r.counts[l.category_of<number>()] == 1u);
+    CHECK(r.counts[l.category_of<word>()] == 1u);
+    CHECK(r.counts[l.category_of<punct>()] == 2u);
+
+    // invalid match
+    {
+        char const input[] = "123abc !";
+
+        auto const r = l.count(
+            input + 0, input + sizeof(input) - 1);
+
+        CHECK(r.last == input + 6);
+        CHECK(r.counts[l.category_of<number>()] == 0u);
+        CHECK(r.counts[l.category_of<word>()] == 1u);
+        CHECK(r.counts[l.category_of<punct>()] == 0u);
+    }
+
+    // empty input
+    {
+        char const input[] = "";
+
+        auto const r = l.count(
+            input + 0, input + sizeof(input) - 1);
+
+        CHECK(r.last == input + 0);
+        CHECK(r.counts[l.category_of<number>()] == 0u);
+        CHECK(r.counts[l.category_of<word>()] == 0u);
+        CHECK(r.counts[l.category_of<punct>()] == 0u);
+    }
+
+    // no evaluate
+    {
+        char const input[] = "123!";
+
+        eggs::lexers::lexer<throwing_evaluate, punct> l;
+
+        auto const r = l.count(
+            input + 0, input + sizeof(input) - 1);
+
+        CHECK(r.last == input + 4);
+        CHECK(r.counts[0] == 1u);
+        CHECK(r.counts[1] == 1u);
+    }
+}
+
+TEST_CASE("lexer<Rules...>::validate(Iterator, Sentinel)", "[lexer.count]")
+{
+    eggs::lexers::lexer<number, word, punct> l;
+
+    {
+        char const input[] = "123abc!";
+
+        CHECK(l.validate(input + 0, input + sizeof(input) - 1));
+    }
+
+    // invalid match
+    {
+        char const input[] = "123abc !";
+
+        CHECK(!l.validate(input + 0, input + sizeof(input) - 1));
+    }
+
+    // empty input
+    {
+        char const input[] = "";
+
+        CHECK(l.validate(input + 0, input + sizeof(input) - 1));
+    }
+
+    // no evaluate
+    {
+        char const input[] = "123!";
+
+        eggs::lexers::lexer<throwing_evaluate, punct> l;
+
+        CHECK(l.validate(input + 0, input + sizeof(input) - 1));
+    }
+}
@@ -0,0 +1,85 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <type_traits>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct throwing_evaluate
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        return number{}(first, last);
+    }
+
+    template <typename I>
+    int evaluate(eggs::lexers::token<I>&& /*token*/) const
+    {
+        throw 0;
+    }
+};
+
+TEST_CASE("lexer<Rules...>::demarcate(Iterator, Sentinel)", "[lexer.demarcate]")
+{
+    char const input[] = "123abc!";
+
+    eggs::lexers::lexer<number, word, rule_with_value<punct, int>> l;
+
+    auto const t = l.demarcate(input + 0, input + sizeof(input) - 1);
+    CHECK((std::is_same_v<
+        decltype(t), eggs::lexers::token<char const*> const>));
+
+    CHECK(t.category() == l.category_of<word>());
+    CHECK(t.first == input + 0);
+    CHECK(t.second == input + 6);
+
+    // value
+    {
+        auto const t = l.demarcate(input + 6, input + sizeof(input) - 1);
+
+        CHECK(t.category() == 2u);
+        CHECK(t.first == input + 6);
+        CHECK(t.second == input + 7);
+    }
+
+    // invalid match
+    {
+        char const input[] = " 123";
+
+        auto const t = l.demarcate(input + 0, input + sizeof(input) - 1);
+
+        CHECK(t.category() == t.no_category);
+        CHECK(t.first == input + 0);
+    }
+
+    // empty input
+    {
+        char const input[] = "";
+
+        auto const t = l.demarcate(input + 0, input + sizeof(input) - 1);
+
+        CHECK(t.category() == t.no_category);
+        CHECK(t.first == input + 0);
+        CHECK(t.second == input + 0);
+    }
+
+    // no evaluate
+    {
+        char const input[] = "123!";
+
+        eggs::lexers::lexer<throwing_evaluate, punct> l;
+
+        auto const t = l.demarcate(input + 0, input + sizeof(input) - 1);
+
+        CHECK(t.category() == 0u);
+        CHECK(t.second == input + 3);
+    }
+}
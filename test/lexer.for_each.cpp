@@ -0,0 +1,133 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct visit
+{
+    std::size_t category;
+    char const* first;
+    char const* last;
+    int value;
+};
+
+struct visitor
+{
+    std::vector<visit>& visits;
+
+    template <std::size_t I>
+    void operator()(
+        std::integral_constant<std::size_t, I>,
+        char const* first, char const* last)
+    {
+        visits.push_back({I, first, last, -1});
+    }
+
+    template <std::size_t I>
+    void operator()(
+        std::integral_constant<std::size_t, I>,
+        char const* first, char const* last, int value)
+    {
+        visits.push_back({I, first, last, value});
+    }
+};
+
+TEST_CASE("lexer<Rules...>::for_each(Iterator, Sentinel, Visitor)", "[lexer.for_each]")
+{
+    char const input[] = "123abc!";
+
+    eggs::lexers::lexer<number, word, punct> l;
+
+    std::vector<visit> vs;
+    auto const last = l.for_each(
+        input + 0, input + sizeof(input) - 1,
+        visitor{vs});
+
+    CHECK(last == input + 7);
+    REQUIRE(vs.size() == 2u);
+    CHECK(vs[0].category == l.category_of<word>());
+    CHECK(vs[0].first == input + 0);
+    CHECK(vs[0].last == input + 6);
+    CHECK(vs[1].category == l.category_of<punct>());
+    CHECK(vs[1].first == input + 6);
+    CHECK(vs[1].last == input + 7);
+
+    // invalid match
+    {
+        char const input[] = "123abc !";
+
+        std::vector<visit> vs;
+        auto const last = l.for_each(
+            input + 0, input + sizeof(input) - 1,
+            visitor{vs});
+
+        CHECK(last == input + 6);
+        REQUIRE(vs.size() == 1u);
+        CHECK(vs[0].category == l.category_of<word>());
+    }
+
+    // empty input
+    {
+        char const input[] = "";
+
+        std::vector<visit> vs;
+        auto const last = l.for_each(
+            input + 0, input + sizeof(input) - 1,
+            visitor{vs});
+
+        CHECK(last == input + 0);
+        CHECK(vs.size() == 0u);
+    }
+
+    // values
+    {
+        char const input[] = "123abc!";
+
+        eggs::lexers::lexer<
+            number_with_value<int>, word, punct_with_value<int>
+        > l{{1}, {}, {3}};
+
+        std::vector<visit> vs;
+        auto const last = l.for_each(
+            input + 0, input + sizeof(input) - 1,
+            visitor{vs});
+
+        CHECK(last == input + 7);
+        REQUIRE(vs.size() == 2u);
+        CHECK(vs[0].category == 1u);
+        CHECK(vs[0].value == -1);
+        CHECK(vs[1].category == 2u);
+        CHECK(vs[1].value == 3);
+    }
+
+    // evaluate
+    {
+        char const input[] = "123 abc";
+
+        eggs::lexers::lexer<
+            rule_with_evaluate<number, int>, rule_with_evaluate<unit, int>
+        > l{{42}, {43}};
+
+        std::vector<visit> vs;
+        auto const last = l.for_each(
+            input + 0, input + sizeof(input) - 1,
+            visitor{vs});
+
+        CHECK(last == input + 3);
+        REQUIRE(vs.size() == 1u);
+        CHECK(vs[0].category == 0u);
+        CHECK(vs[0].value == 42);
+    }
+}
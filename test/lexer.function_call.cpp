@@ -6,7 +6,9 @@
 // file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
 #include <eggs/lexer/lexer.hpp>
+#include <forward_list>
 #include <iterator>
+#include <string>
 #include <vector>
 
 #define CATCH_CONFIG_MAIN
@@ -56,3 +58,85 @@ TEST_CASE("lexer<Rules...>::operator()(Iterator, Sentinel, OutputIterator)", "[l
         CHECK(ts.size() == 0u);
     }
 }
+
+TEST_CASE("lexer<Rules...>::operator()(ExecutionPolicy&&, Iterator, Sentinel, OutputIterator)", "[lexer.function_call]")
+{
+    namespace execution = eggs::lexers::execution;
+
+    std::string input;
+    for (int i = 0; i < 5000; ++i)
+        input += std::to_string(i * 7919) + "abc" + std::string(i % 37, 'x') + "!";
+    char const* const first = input.data();
+    char const* const last = input.data() + input.size();
+
+    eggs::lexers::lexer<number, word, punct> l;
+
+    std::vector<eggs::lexers::token<char const*>> expected;
+    REQUIRE(l(first, last, std::back_inserter(expected)) == last);
+
+    auto const same = [](auto const& lhs, auto const& rhs)
+    {
+        if (lhs.size() != rhs.size())
+            return false;
+        for (std::size_t i = 0; i < lhs.size(); ++i)
+        {
+            if (lhs[i].category() != rhs[i].category()
+             || lhs[i].first != rhs[i].first || lhs[i].second != rhs[i].second)
+                return false;
+        }
+        return true;
+    };
+
+    CHECK(eggs::lexers::is_execution_policy_v<execution::sequenced_policy>);
+    CHECK(eggs::lexers::is_execution_policy_v<execution::parallel_policy>);
+    CHECK_FALSE(eggs::lexers::is_execution_policy_v<char const*>);
+
+    // sequenced
+    {
+        std::vector<eggs::lexers::token<char const*>> ts;
+        CHECK(l(execution::seq, first, last, std::back_inserter(ts)) == last);
+        CHECK(same(ts, expected));
+    }
+
+    // parallel
+    {
+        eggs::lexers::parallel_options opts;
+        opts.threads = 4;
+        opts.min_chunk_size = 1024;
+
+        std::vector<eggs::lexers::token<char const*>> ts;
+        CHECK(l(execution::par.with(opts), first, last,
+            std::back_inserter(ts)) == last);
+        CHECK(same(ts, expected));
+
+        std::vector<eggs::lexers::token<char const*>> default_ts;
+        CHECK(l(execution::par, first, last,
+            std::back_inserter(default_ts)) == last);
+        CHECK(same(default_ts, expected));
+    }
+
+    // forward iterator
+    {
+        std::forward_list<char> const list(first, last);
+
+        std::vector<eggs::lexers::token<std::forward_list<char>::const_iterator>> ts;
+        CHECK(l(execution::par, list.begin(), list.end(),
+            std::back_inserter(ts)) == list.end());
+        CHECK(ts.size() == expected.size());
+    }
+
+#if EGGS_LEXER_HAS_STD_EXECUTION
+    // standard policies
+    {
+        std::vector<eggs::lexers::token<char const*>> ts;
+        CHECK(l(std::execution::par, first, last,
+            std::back_inserter(ts)) == last);
+        CHECK(same(ts, expected));
+
+        std::vector<eggs::lexers::token<char const*>> seq_ts;
+        CHECK(l(std::execution::seq, first, last,
+            std::back_inserter(seq_ts)) == last);
+        CHECK(same(seq_ts, expected));
+    }
+#endif
+}
@@ -0,0 +1,90 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/indexed_value.hpp>
+#include <eggs/lexer/lexer.hpp>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("lexer<Rules...>::indexed()", "[lexer.indexed]")
+{
+    using eggs::lexers::get_value;
+    using eggs::lexers::get_value_if;
+
+    eggs::lexers::lexer<
+        number_with_value<int>, punct, rule_with_evaluate<word, double>
+    > l(number_with_value<int>{42}, punct{},
+        rule_with_evaluate<word, double>{3.5});
+    auto const il = l.indexed();
+    using token = decltype(il)::token<char const*>;
+
+    static_assert(std::is_same_v<token::value_type,
+        eggs::lexers::indexed_value<int, std::monostate, double>>);
+    static_assert(sizeof(token::value_type) == sizeof(double));
+    static_assert(sizeof(token) < sizeof(decltype(l)::token<char const*>));
+    static_assert(decltype(il)::category_of<punct>() == 1);
+
+    // tokenize
+    {
+        std::string const input = "123";
+        token t = il.tokenize(input.data(), input.data() + input.size());
+        CHECK(t.category() == 0);
+        CHECK(t.first == input.data());
+        CHECK(t.second == input.data() + 3);
+        CHECK(get_value<0>(t) == 42);
+        REQUIRE(get_value_if<0>(&t) != nullptr);
+        CHECK(*get_value_if<0>(&t) == 42);
+        CHECK(get_value_if<2>(&t) == nullptr);
+        CHECK_THROWS_AS(get_value<2>(t), std::bad_variant_access const&);
+
+        get_value<0>(t) = 7;
+        token const& ct = t;
+        CHECK(get_value<0>(ct) == 7);
+
+        token const empty = il.tokenize(input.data(), input.data());
+        CHECK(empty.category() == token::no_category);
+        CHECK(get_value_if<0>(&empty) == nullptr);
+
+        token* const null = nullptr;
+        CHECK(get_value_if<0>(null) == nullptr);
+    }
+
+    // operator()
+    {
+        std::string const input = "123!abc? invalid";
+        char const* const first = input.data();
+        char const* const last = input.data() + input.size();
+
+        std::vector<decltype(l)::token<char const*>> expected;
+        char const* const expected_last =
+            l(first, last, std::back_inserter(expected));
+
+        std::vector<token> tokens;
+        CHECK(il(first, last, std::back_inserter(tokens)) == expected_last);
+
+        REQUIRE(tokens.size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            CHECK(tokens[i].category() == expected[i].category());
+            CHECK(tokens[i].first == expected[i].first);
+            CHECK(tokens[i].second == expected[i].second);
+        }
+
+        CHECK(get_value<0>(tokens[0]) == 42);
+        CHECK(get_value<1>(tokens[1]) == std::monostate{});
+        CHECK(get_value<2>(tokens[2]) == 3.5);
+        CHECK(std::get<double>(expected[2].value) == 3.5);
+    }
+}
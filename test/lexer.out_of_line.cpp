@@ -0,0 +1,121 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/side_table.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+using big_value = std::array<char, 64>;
+
+// a word whose value is a large copy of its lexeme
+struct big_word
+{
+    template <typename I, typename S>
+    std::pair<I, big_value> operator()(I first, S last) const
+    {
+        I const mark = word{}(first, last);
+        big_value value = {};
+        std::copy(first, mark, value.begin());
+        return std::make_pair(mark, value);
+    }
+};
+
+TEST_CASE("side_table", "[side_table]")
+{
+    eggs::lexers::side_table table;
+    CHECK(table.size<std::string>() == 0);
+
+    auto const a = table.push(std::string("a"));
+    auto const b = table.push(std::string("b"));
+    auto const one = table.push(1);
+    static_assert(std::is_same_v<
+        decltype(a), eggs::lexers::side_ref<std::string> const>);
+
+    CHECK(a.id == 0);
+    CHECK(b.id == 1);
+    CHECK(one.id == 0);
+    CHECK(a != b);
+    CHECK(table[a] == "a");
+    CHECK(table[b] == "b");
+    CHECK(table[one] == 1);
+    CHECK(table.size<std::string>() == 2);
+    CHECK(table.size<int>() == 1);
+
+    table[a] += "x";
+    eggs::lexers::side_table const& ctable = table;
+    CHECK(ctable[a] == "ax");
+
+    table.clear();
+    CHECK(table.size<std::string>() == 0);
+    CHECK(table.size<int>() == 0);
+}
+
+TEST_CASE("lexer<Rules...>::out_of_line(side_table&)", "[lexer.out_of_line]")
+{
+    using eggs::lexers::side_ref;
+
+    eggs::lexers::lexer<number_with_value<int>, big_word, punct> l(
+        number_with_value<int>{42}, big_word{}, punct{});
+    using token = decltype(l)::token<char const*>;
+
+    eggs::lexers::side_table table;
+    auto const ol = l.out_of_line(table);
+    using ol_token = decltype(ol)::token<char const*>;
+
+    static_assert(std::is_same_v<ol_token::value_type,
+        std::variant<std::monostate, int, side_ref<big_value>>>);
+    static_assert(sizeof(ol_token) < sizeof(token));
+
+    std::string const input = "123abc!456def? invalid";
+    char const* const first = input.data();
+    char const* const last = input.data() + input.size();
+
+    std::vector<token> expected;
+    char const* const expected_last =
+        l(first, last, std::back_inserter(expected));
+
+    std::vector<ol_token> tokens;
+    CHECK(ol(first, last, std::back_inserter(tokens)) == expected_last);
+
+    REQUIRE(tokens.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        CHECK(tokens[i].category() == expected[i].category());
+        CHECK(tokens[i].first == expected[i].first);
+        CHECK(tokens[i].second == expected[i].second);
+        if (auto const* ref = std::get_if<2>(&tokens[i].value))
+            CHECK(table[*ref] == std::get<2>(expected[i].value));
+    }
+    CHECK(table.size<big_value>() == 2);
+
+    // small values stay inline
+    {
+        std::string const digits = "789";
+        auto const t = ol.tokenize(digits.data(), digits.data() + 3);
+        CHECK(std::get<int>(t.value) == 42);
+        CHECK(table.size<big_value>() == 2);
+    }
+
+    // a larger threshold keeps every value inline
+    {
+        auto const il = l.out_of_line<64>(table);
+        using il_token = decltype(il)::token<char const*>;
+        static_assert(std::is_same_v<il_token::value_type, token::value_type>);
+    }
+}
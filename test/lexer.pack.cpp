@@ -0,0 +1,123 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/packed_token.hpp>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("basic_packed_token<Word>", "[packed_token]")
+{
+    using eggs::lexers::packed_token;
+    using eggs::lexers::wide_packed_token;
+
+    static_assert(sizeof(packed_token) == 8);
+    static_assert(sizeof(wide_packed_token) == 16);
+    static_assert(packed_token::max_category == 254);
+    static_assert(packed_token::max_length == 0xFFFFFF);
+    static_assert(packed_token::max_offset == 0xFFFFFFFF);
+
+    constexpr packed_token e;
+    CHECK(e.category() == packed_token::no_category);
+    CHECK(e.offset() == 0);
+    CHECK(e.length() == 0);
+
+    constexpr packed_token t(254, 0xFFFFFFFF, 0xFFFFFF);
+    CHECK(t.category() == 254);
+    CHECK(t.offset() == 0xFFFFFFFF);
+    CHECK(t.length() == 0xFFFFFF);
+    CHECK(t != e);
+    CHECK(t == packed_token(254, 0xFFFFFFFF, 0xFFFFFF));
+
+    constexpr wide_packed_token w(3, 0x100000000ull, 0x1000000);
+    CHECK(w.category() == 3);
+    CHECK(w.offset() == 0x100000000ull);
+    CHECK(w.length() == 0x1000000);
+
+    char const input[] = "abc 123";
+    auto const u = packed_token(1, 4, 3).unpack(input + 0);
+    CHECK(u.category() == 1);
+    CHECK(u.first == input + 4);
+    CHECK(u.second == input + 7);
+}
+
+TEST_CASE("lexer<Rules...>::pack(Iterator, Sentinel, OutputIterator)", "[lexer.pack]")
+{
+    using eggs::lexers::packed_token;
+
+    // demarcates like operator(), ignoring values
+    {
+        eggs::lexers::lexer<number_with_value<int>, word, punct> l;
+        using token = decltype(l)::token<char const*>;
+
+        std::string const input = "123abc!456def? invalid";
+        char const* const first = input.data();
+        char const* const last = input.data() + input.size();
+
+        std::vector<token> expected;
+        char const* const expected_last =
+            l(first, last, std::back_inserter(expected));
+
+        std::vector<packed_token> tokens;
+        CHECK(l.pack(first, last, std::back_inserter(tokens)) == expected_last);
+
+        REQUIRE(tokens.size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            auto const t = tokens[i].unpack(first);
+            CHECK(t.category() == expected[i].category());
+            CHECK(t.first == expected[i].first);
+            CHECK(t.second == expected[i].second);
+        }
+    }
+
+    // forward iterators
+    {
+        eggs::lexers::lexer<number, word> l;
+
+        std::string const text = "12ab34";
+        std::list<char> const input(text.begin(), text.end());
+
+        std::vector<eggs::lexers::wide_packed_token> tokens;
+        CHECK(l.pack<eggs::lexers::wide_packed_token>(
+            input.begin(), input.end(), std::back_inserter(tokens))
+         == input.end());
+
+        REQUIRE(tokens.size() == 1);
+        CHECK(tokens[0].category() == 1);
+        CHECK(tokens[0].offset() == 0);
+        CHECK(tokens[0].length() == 6);
+    }
+
+    // lexeme too long
+    {
+        eggs::lexers::lexer<number> l;
+
+        std::string const input(packed_token::max_length + 1, '7');
+
+        std::vector<packed_token> tokens;
+        CHECK_THROWS_AS(
+            l.pack(input.data(), input.data() + input.size(),
+                std::back_inserter(tokens)),
+            std::length_error const&);
+
+        std::vector<eggs::lexers::wide_packed_token> wide;
+        CHECK(l.pack<eggs::lexers::wide_packed_token>(
+            input.data(), input.data() + input.size(),
+            std::back_inserter(wide)) == input.data() + input.size());
+        REQUIRE(wide.size() == 1);
+        CHECK(wide[0].length() == input.size());
+    }
+}
@@ -0,0 +1,311 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/parallel.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <variant>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct space
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        while (first != last && (*first == ' ' || *first == '\n')) ++first;
+        return first;
+    }
+};
+
+struct newline
+{
+    template <typename I, typename S>
+    I operator()(I first, S /*last*/) const
+    {
+        if (*first == '\n') ++first;
+        return first;
+    }
+};
+
+struct blank
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        while (first != last && *first == ' ') ++first;
+        return first;
+    }
+};
+
+struct quoted
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        if (first == last || *first != '"')
+            return first;
+        for (I iter = std::next(first); iter != last; ++iter)
+            if (*iter == '"')
+                return ++iter;
+        return first;
+    }
+};
+
+struct lexeme
+{
+    std::size_t category;
+    char const* first;
+    char const* second;
+
+    template <typename Token>
+    lexeme(Token const& t)
+      : category(t.category())
+      , first(t.first)
+      , second(t.second)
+    {}
+
+    friend bool operator==(lexeme const& lhs, lexeme const& rhs)
+    {
+        return lhs.category == rhs.category
+            && lhs.first == rhs.first && lhs.second == rhs.second;
+    }
+};
+
+TEST_CASE("parallel_lex(Lexer const&, RandomAccessIterator, RandomAccessIterator, OutputIterator, parallel_options const&)", "[lexer.parallel_lex]")
+{
+    eggs::lexers::lexer<quoted, number, word, punct, space> l;
+
+    std::string input;
+    for (int i = 0; i < 3000; ++i)
+    {
+        input += std::to_string(i * 7919) + " abc" + std::string(i % 37, 'x');
+        input += i % 5 == 0 ? " \"quoted 123 " + std::string(i % 53, 'q') + "\"" : "!";
+        input += i % 7 == 0 ? "\n" : " ";
+    }
+    char const* const first = input.data();
+    char const* const last = input.data() + input.size();
+
+    std::vector<lexeme> expected;
+    REQUIRE(l(first, last, std::back_inserter(expected)) == last);
+
+    for (std::size_t threads : {1u, 2u, 3u, 8u, 61u})
+    {
+        eggs::lexers::parallel_options opts;
+        opts.threads = threads;
+        opts.min_chunk_size = 1;
+
+        std::vector<lexeme> ts;
+        CHECK(eggs::lexers::parallel_lex(
+            l, first, last, std::back_inserter(ts), opts) == last);
+        CHECK(ts == expected);
+    }
+
+    // invalid match
+    {
+        std::string const bad = input + "\x01" + input;
+        char const* const first = bad.data();
+        char const* const last = bad.data() + bad.size();
+
+        std::vector<lexeme> expected;
+        char const* const error = l(first, last, std::back_inserter(expected));
+        REQUIRE(error == first + input.size());
+
+        for (std::size_t threads : {2u, 8u, 61u})
+        {
+            eggs::lexers::parallel_options opts;
+            opts.threads = threads;
+            opts.min_chunk_size = 1;
+
+            std::vector<lexeme> ts;
+            CHECK(eggs::lexers::parallel_lex(
+                l, first, last, std::back_inserter(ts), opts) == error);
+            CHECK(ts == expected);
+        }
+    }
+
+    // unterminated quote spans chunks
+    {
+        std::string const open = "\"" + input;
+        char const* const first = open.data();
+        char const* const last = open.data() + open.size();
+
+        std::vector<lexeme> expected;
+        REQUIRE(l(first, last, std::back_inserter(expected)) == last);
+
+        eggs::lexers::parallel_options opts;
+        opts.threads = 8;
+        opts.min_chunk_size = 1;
+
+        std::vector<lexeme> ts;
+        CHECK(eggs::lexers::parallel_lex(
+            l, first, last, std::back_inserter(ts), opts) == last);
+        CHECK(ts == expected);
+    }
+
+    // small input
+    {
+        std::vector<lexeme> ts;
+        CHECK(eggs::lexers::parallel_lex(
+            l, first, first + 10, std::back_inserter(ts)) == first + 10);
+        CHECK(ts.size() == 6u);
+    }
+}
+
+TEST_CASE("parallel_lex_records(Lexer const&, RandomAccessIterator, RandomAccessIterator, OutputIterator, Char, parallel_options const&)", "[lexer.parallel_lex]")
+{
+    std::string input;
+    for (int i = 0; i < 3000; ++i)
+    {
+        input += std::to_string(i * 7919) + ",abc" + std::string(i % 37, 'x');
+        input += i % 5 == 0 ? ", \"quoted 123\"" : ",!";
+        input += i % 7 == 0 ? "\n\n  \n" : "\n";
+    }
+    char const* const first = input.data();
+    char const* const last = input.data() + input.size();
+
+    // separator is never inside a token
+    {
+        eggs::lexers::lexer<quoted, number, word, punct, blank, newline> l;
+
+        std::vector<lexeme> expected;
+        REQUIRE(l(first, last, std::back_inserter(expected)) == last);
+
+        for (std::size_t threads : {1u, 2u, 3u, 8u, 61u})
+        {
+            eggs::lexers::parallel_options opts;
+            opts.threads = threads;
+            opts.min_chunk_size = 1;
+
+            std::vector<lexeme> ts;
+            CHECK(eggs::lexers::parallel_lex_records(
+                l, first, last, std::back_inserter(ts), '\n', opts) == last);
+            CHECK(ts == expected);
+        }
+    }
+
+    // separator is inside some tokens
+    {
+        eggs::lexers::lexer<quoted, number, word, punct, space> l;
+
+        std::vector<lexeme> expected;
+        REQUIRE(l(first, last, std::back_inserter(expected)) == last);
+
+        for (std::size_t threads : {2u, 8u, 61u})
+        {
+            eggs::lexers::parallel_options opts;
+            opts.threads = threads;
+            opts.min_chunk_size = 1;
+
+            std::vector<lexeme> ts;
+            CHECK(eggs::lexers::parallel_lex_records(
+                l, first, last, std::back_inserter(ts), '\n', opts) == last);
+            CHECK(ts == expected);
+        }
+    }
+
+    // no separator
+    {
+        eggs::lexers::lexer<quoted, number, word, punct, blank, newline> l;
+        std::string const line(1000, 'a');
+
+        eggs::lexers::parallel_options opts;
+        opts.threads = 8;
+        opts.min_chunk_size = 1;
+
+        std::vector<lexeme> ts;
+        CHECK(eggs::lexers::parallel_lex_records(
+            l, line.data(), line.data() + line.size(),
+            std::back_inserter(ts), '\n', opts) == line.data() + line.size());
+        CHECK(ts.size() == 1u);
+    }
+}
+
+TEST_CASE("parallel_lex_into(Lexer const&, RandomAccessIterator, RandomAccessIterator, std::vector<token>&, parallel_options const&)", "[lexer.parallel_lex]")
+{
+    eggs::lexers::lexer<quoted, number, word, punct, space> l;
+    using token = decltype(l)::token<char const*>;
+
+    std::string input;
+    for (int i = 0; i < 3000; ++i)
+    {
+        input += std::to_string(i * 7919) + " abc" + std::string(i % 37, 'x');
+        input += i % 5 == 0 ? " \"quoted 123 " + std::string(i % 53, 'q') + "\"" : "!";
+        input += i % 1000 == 999 ? "\"" + std::string(10000, ' ') + "\"" : "";
+        input += i % 7 == 0 ? "\n" : " ";
+    }
+    char const* const first = input.data();
+    char const* const last = input.data() + input.size();
+
+    std::vector<lexeme> expected;
+    REQUIRE(l(first, last, std::back_inserter(expected)) == last);
+
+    for (std::size_t threads : {1u, 2u, 3u, 8u, 61u})
+    {
+        eggs::lexers::parallel_options opts;
+        opts.threads = threads;
+        opts.min_chunk_size = 1;
+
+        std::vector<token> ts(1);
+        CHECK(eggs::lexers::parallel_lex_into(l, first, last, ts, opts) == last);
+        REQUIRE(ts.size() == expected.size() + 1);
+        CHECK(std::vector<lexeme>(ts.begin() + 1, ts.end()) == expected);
+    }
+
+    // invalid match
+    {
+        std::string const bad = input + "\x01" + input;
+        char const* const first = bad.data();
+        char const* const last = bad.data() + bad.size();
+
+        std::vector<lexeme> expected;
+        char const* const error = l(first, last, std::back_inserter(expected));
+        REQUIRE(error == first + input.size());
+
+        for (std::size_t threads : {2u, 8u, 61u})
+        {
+            eggs::lexers::parallel_options opts;
+            opts.threads = threads;
+            opts.min_chunk_size = 1;
+
+            std::vector<token> ts;
+            CHECK(eggs::lexers::parallel_lex_into(l, first, last, ts, opts) == error);
+            CHECK(std::vector<lexeme>(ts.begin(), ts.end()) == expected);
+        }
+    }
+
+    // values
+    {
+        eggs::lexers::lexer<
+            rule_with_evaluate<number, int>, quoted, word, punct, space> l(
+                rule_with_evaluate<number, int>{42},
+                quoted{}, word{}, punct{}, space{});
+        using token = decltype(l)::token<char const*>;
+
+        std::vector<token> expected;
+        REQUIRE(l(first, last, std::back_inserter(expected)) == last);
+
+        eggs::lexers::parallel_options opts;
+        opts.threads = 8;
+        opts.min_chunk_size = 1;
+
+        std::vector<token> ts;
+        CHECK(eggs::lexers::parallel_lex_into(l, first, last, ts, opts) == last);
+        CHECK(std::vector<lexeme>(ts.begin(), ts.end())
+            == std::vector<lexeme>(expected.begin(), expected.end()));
+        CHECK(std::equal(ts.begin(), ts.end(), expected.begin(),
+            [](token const& lhs, token const& rhs)
+            { return lhs.value == rhs.value; }));
+        CHECK(std::get<int>(ts.front().value) == 42);
+    }
+}
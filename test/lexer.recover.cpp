@@ -0,0 +1,133 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <iterator>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("lexer<Rules...>::recover(Iterator, Sentinel, OutputIterator)", "[lexer.recover]")
+{
+    using token = eggs::lexers::token<char const*>;
+
+    char const input[] = "123  abc !";
+
+    eggs::lexers::lexer<number, word, punct> l;
+
+    std::vector<token> ts;
+    auto const last = l.recover(
+        input + 0, input + sizeof(input) - 1,
+        std::back_inserter(ts));
+
+    CHECK(last == input + 10);
+    REQUIRE(ts.size() == 5u);
+    CHECK(ts[0].category() == l.category_of<number>());
+    CHECK(ts[1].category() == token::no_category);
+    CHECK(ts[1].first == input + 3);
+    CHECK(ts[1].second == input + 5);
+    CHECK(ts[2].category() == l.category_of<word>());
+    CHECK(ts[3].category() == token::no_category);
+    CHECK(ts[3].first == input + 8);
+    CHECK(ts[3].second == input + 9);
+    CHECK(ts[4].category() == l.category_of<punct>());
+
+    // trailing error
+    {
+        char const input[] = "123  ";
+
+        std::vector<token> ts;
+        auto const last = l.recover(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts));
+
+        CHECK(last == input + 5);
+        REQUIRE(ts.size() == 2u);
+        CHECK(ts[1].category() == token::no_category);
+        CHECK(ts[1].first == input + 3);
+        CHECK(ts[1].second == input + 5);
+    }
+
+    // empty input
+    {
+        char const input[] = "";
+
+        std::vector<token> ts;
+        auto const last = l.recover(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts));
+
+        CHECK(last == input + 0);
+        CHECK(ts.size() == 0u);
+    }
+
+    // values
+    {
+        char const input[] = "  12";
+
+        eggs::lexers::lexer<number_with_value<int>> l{{42}};
+
+        std::vector<eggs::lexers::token<char const*, int>> ts;
+        auto const last = l.recover(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts));
+
+        CHECK(last == input + 4);
+        REQUIRE(ts.size() == 2u);
+        CHECK(ts[0].category() == token::no_category);
+        CHECK(ts[0].value == 0);
+        CHECK(ts[1].category() == 0u);
+        CHECK(ts[1].value == 42);
+    }
+}
+
+TEST_CASE("lexer<Rules...>::recover(Iterator, Sentinel, OutputIterator, char_set const&)", "[lexer.recover]")
+{
+    using token = eggs::lexers::token<char const*>;
+
+    char const input[] = "12 x+ 34";
+
+    eggs::lexers::lexer<number, punct> l;
+
+    // resyncs on digits only, skipping the punctuation that follows an
+    // invalid token
+    std::vector<token> ts;
+    auto const last = l.recover(
+        input + 0, input + sizeof(input) - 1,
+        std::back_inserter(ts), "0123456789");
+
+    CHECK(last == input + 8);
+    REQUIRE(ts.size() == 3u);
+    CHECK(ts[0].category() == l.category_of<number>());
+    CHECK(ts[1].category() == token::no_category);
+    CHECK(ts[1].first == input + 2);
+    CHECK(ts[1].second == input + 6);
+    CHECK(ts[2].category() == l.category_of<number>());
+    CHECK(ts[2].first == input + 6);
+
+    // punctuation that follows a valid token is not skipped
+    {
+        char const input[] = "12+ x 34";
+
+        std::vector<token> ts;
+        auto const last = l.recover(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts), "0123456789");
+
+        CHECK(last == input + 8);
+        REQUIRE(ts.size() == 4u);
+        CHECK(ts[0].category() == l.category_of<number>());
+        CHECK(ts[1].category() == l.category_of<punct>());
+        CHECK(ts[1].first == input + 2);
+        CHECK(ts[2].category() == token::no_category);
+        CHECK(ts[2].first == input + 3);
+        CHECK(ts[2].second == input + 6);
+        CHECK(ts[3].category() == l.category_of<number>());
+    }
+}
@@ -0,0 +1,177 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <cctype>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct space
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        while (first != last && std::isspace(*first)) ++first;
+        return first;
+    }
+};
+
+struct throwing_space
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        return space{}(first, last);
+    }
+
+    template <typename I>
+    int evaluate(eggs::lexers::token<I>&& /*token*/) const
+    {
+        throw 0;
+    }
+};
+
+TEST_CASE("lexer<Rules...>::skip<SkipRules...>()", "[lexer.skip]")
+{
+    eggs::lexers::lexer<number, word, space, punct> l;
+
+    auto const sl = l.skip<space, punct>();
+
+    CHECK(sl.category_of<number>() == l.category_of<number>());
+    CHECK(sl.category_of<space>() == l.category_of<space>());
+    CHECK(!sl.is_skipped(l.category_of<number>()));
+    CHECK(!sl.is_skipped(l.category_of<word>()));
+    CHECK(sl.is_skipped(l.category_of<space>()));
+    CHECK(sl.is_skipped(l.category_of<punct>()));
+    CHECK(!sl.is_skipped(eggs::lexers::token<char const*>::no_category));
+
+    // constexpr
+    {
+        constexpr eggs::lexers::lexer<number, word, space> l;
+        constexpr auto sl = l.skip<space>();
+
+        static_assert(sl.is_skipped(2u));
+        static_assert(!sl.is_skipped(0u));
+    }
+}
+
+TEST_CASE("skip_lexer<Lexer, SkipRules...>::operator()(Iterator, Sentinel, OutputIterator)", "[lexer.skip]")
+{
+    char const input[] = "123 abc, 45";
+
+    eggs::lexers::lexer<number, word, space, punct> l;
+    auto const sl = l.skip<space, punct>();
+
+    std::vector<eggs::lexers::token<char const*>> ts;
+    auto const last = sl(
+        input + 0, input + sizeof(input) - 1,
+        std::back_inserter(ts));
+
+    CHECK(last == input + 11);
+    REQUIRE(ts.size() == 3u);
+    CHECK(ts[0].category() == l.category_of<number>());
+    CHECK(ts[0].first == input + 0);
+    CHECK(ts[0].second == input + 3);
+    CHECK(ts[1].category() == l.category_of<word>());
+    CHECK(ts[1].first == input + 4);
+    CHECK(ts[1].second == input + 7);
+    CHECK(ts[2].category() == l.category_of<number>());
+    CHECK(ts[2].first == input + 9);
+    CHECK(ts[2].second == input + 11);
+
+    // invalid match
+    {
+        char const input[] = "123 abc\x01" "45";
+
+        std::vector<eggs::lexers::token<char const*>> ts;
+        auto const last = sl(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts));
+
+        CHECK(last == input + 7);
+        CHECK(ts.size() == 2u);
+    }
+
+    // values
+    {
+        char const input[] = "123 abc";
+
+        eggs::lexers::lexer<
+            number_with_value<int>, word_with_value<char>, space
+        > l{{1}, {'a'}, {}};
+        auto const sl = l.skip<space>();
+
+        using token = decltype(sl)::token<char const*>;
+        std::vector<token> ts;
+        auto const last = sl(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts));
+
+        CHECK(last == input + 7);
+        REQUIRE(ts.size() == 2u);
+        CHECK(ts[0].value.index() == 1u);
+        CHECK(std::get<1>(ts[0].value) == 1);
+        CHECK(ts[1].value.index() == 2u);
+        CHECK(std::get<2>(ts[1].value) == 'a');
+    }
+
+    // no evaluate
+    {
+        char const input[] = "123 45";
+
+        eggs::lexers::lexer<number, throwing_space> l;
+        auto const sl = l.skip<throwing_space>();
+
+        using token = decltype(sl)::token<char const*>;
+        std::vector<token> ts;
+        auto const last = sl(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts));
+
+        CHECK(last == input + 6);
+        CHECK(ts.size() == 2u);
+    }
+}
+
+struct visitor
+{
+    std::vector<std::size_t>& categories;
+
+    template <std::size_t I, typename ...Args>
+    void operator()(
+        std::integral_constant<std::size_t, I>,
+        char const* /*first*/, char const* /*last*/, Args&&...)
+    {
+        categories.push_back(I);
+    }
+};
+
+TEST_CASE("skip_lexer<Lexer, SkipRules...>::for_each(Iterator, Sentinel, Visitor)", "[lexer.skip]")
+{
+    char const input[] = "123 abc, 45";
+
+    eggs::lexers::lexer<number, word, space, punct> l;
+    auto const sl = l.skip<space>();
+
+    std::vector<std::size_t> cs;
+    auto const last = sl.for_each(
+        input + 0, input + sizeof(input) - 1,
+        visitor{cs});
+
+    CHECK(last == input + 11);
+    REQUIRE(cs.size() == 4u);
+    CHECK(cs[0] == l.category_of<number>());
+    CHECK(cs[1] == l.category_of<word>());
+    CHECK(cs[2] == l.category_of<punct>());
+    CHECK(cs[3] == l.category_of<number>());
+}
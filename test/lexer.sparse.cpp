@@ -0,0 +1,134 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <cctype>
+#include <iterator>
+#include <list>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct space
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        while (first != last && std::isspace(*first)) ++first;
+        return first;
+    }
+};
+
+struct quoted
+{
+    template <typename I, typename S>
+    I operator()(I first, S last) const
+    {
+        if (*first != '"') return first;
+
+        I iter = first;
+        for (++iter; iter != last; ++iter)
+            if (*iter == '"') return ++iter;
+        return first;
+    }
+};
+
+TEST_CASE("lexer<Rules...>::sparse<Targets...>(Iterator, Sentinel, OutputIterator, char_set const&, char_set const&)", "[lexer.sparse]")
+{
+    char const input[] =
+        "abc \"def\" 12;\n"
+        "x = \"y;z\" + 3;\n"
+        "no strings here;\n"
+        "\"a\"\"b\";";
+
+    eggs::lexers::lexer<number, word, space, punct, quoted> l;
+
+    std::vector<eggs::lexers::token<char const*>> all;
+    auto const all_last = l(
+        input + 0, input + sizeof(input) - 1,
+        std::back_inserter(all));
+    REQUIRE(all_last == input + sizeof(input) - 1);
+
+    std::vector<eggs::lexers::token<char const*>> expected;
+    for (auto const& t : all)
+        if (t.category() == l.category_of<quoted>())
+            expected.push_back(t);
+    REQUIRE(expected.size() == 4u);
+
+    // single anchor
+    {
+        std::vector<eggs::lexers::token<char const*>> ts;
+        auto const last = l.sparse<quoted>(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts), "\"", ";");
+
+        CHECK(last == input + sizeof(input) - 1);
+        REQUIRE(ts.size() == expected.size());
+        for (std::size_t i = 0; i < ts.size(); ++i)
+        {
+            CHECK(ts[i].category() == expected[i].category());
+            CHECK(ts[i].first == expected[i].first);
+            CHECK(ts[i].second == expected[i].second);
+        }
+    }
+
+    // multiple anchors and targets
+    {
+        std::vector<eggs::lexers::token<char const*>> ts;
+        auto const last = l.sparse<quoted, number>(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts), "\"0123456789", "\n");
+
+        CHECK(last == input + sizeof(input) - 1);
+        REQUIRE(ts.size() == 6u);
+        CHECK(ts[1].category() == l.category_of<number>());
+        CHECK(ts[1].first == input + 10);
+        CHECK(ts[1].second == input + 12);
+        CHECK(ts[3].category() == l.category_of<number>());
+    }
+
+    // forward iterators
+    {
+        std::list<char> const input_list(input + 0, input + sizeof(input) - 1);
+
+        std::vector<eggs::lexers::token<std::list<char>::const_iterator>> ts;
+        auto const last = l.sparse<quoted>(
+            input_list.begin(), input_list.end(),
+            std::back_inserter(ts), "\"", ";");
+
+        CHECK(last == input_list.end());
+        CHECK(ts.size() == expected.size());
+    }
+
+    // invalid match
+    {
+        char const input[] = "abc; \"d\" \x01 \"e\"";
+
+        std::vector<eggs::lexers::token<char const*>> ts;
+        auto const last = l.sparse<quoted>(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts), "\"", ";");
+
+        CHECK(last == input + 9);
+        CHECK(ts.size() == 1u);
+    }
+
+    // no anchors
+    {
+        char const input[] = "abc def";
+
+        std::vector<eggs::lexers::token<char const*>> ts;
+        auto const last = l.sparse<quoted>(
+            input + 0, input + sizeof(input) - 1,
+            std::back_inserter(ts), "\"", ";");
+
+        CHECK(last == input + 7);
+        CHECK(ts.size() == 0u);
+    }
+}
@@ -0,0 +1,122 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/token_table.hpp>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("lexer<Rules...>::tabulate(Iterator, Sentinel, token_table<Iterator, Value>&)", "[lexer.tabulate]")
+{
+    std::string const input = "123abc!456def? invalid";
+    char const* const first = input.data();
+    char const* const last = input.data() + input.size();
+
+    // with values
+    {
+        eggs::lexers::lexer<
+            number_with_value<int>, word_with_value<int>, punct_with_value<int>
+        > l(number_with_value<int>{1}, word_with_value<int>{2},
+            punct_with_value<int>{3});
+        using token = decltype(l)::token<char const*>;
+
+        std::vector<token> expected;
+        char const* const expected_last =
+            l(first, last, std::back_inserter(expected));
+
+        eggs::lexers::token_table<char const*, int> table(first);
+        CHECK(l.tabulate(first, last, table) == expected_last);
+
+        REQUIRE(table.size() == expected.size());
+        REQUIRE(table.categories().size() == expected.size());
+        REQUIRE(table.offsets().size() == expected.size());
+        REQUIRE(table.lengths().size() == expected.size());
+        REQUIRE(table.values().size() == expected.size());
+        for (std::size_t i = 0; i < expected.size(); ++i)
+        {
+            CHECK(table.categories()[i] == expected[i].category());
+            CHECK(table.offsets()[i] == std::size_t(expected[i].first - first));
+            CHECK(table.lengths()[i]
+                == std::size_t(expected[i].second - expected[i].first));
+            CHECK(table.values()[i] == expected[i].value);
+
+            token const row = table[i];
+            CHECK(row.category() == expected[i].category());
+            CHECK(row.first == expected[i].first);
+            CHECK(row.second == expected[i].second);
+            CHECK(row.value == expected[i].value);
+        }
+
+        // row view
+        std::size_t i = 0;
+        for (token const& row : table)
+        {
+            CHECK(row.first == expected.at(i).first);
+            ++i;
+        }
+        CHECK(i == expected.size());
+
+        // appends, relative to base
+        char const* const resume = first + 7;
+        CHECK(l.tabulate(resume, expected_last, table) == expected_last);
+        REQUIRE(table.size() == expected.size() + 2);
+        CHECK(table.offsets()[expected.size()] == 7);
+        CHECK(table[expected.size()].first == resume);
+
+        table.clear();
+        CHECK(table.empty());
+    }
+
+    // without values
+    {
+        eggs::lexers::lexer<number_with_value<int>, word, punct> l;
+
+        eggs::lexers::token_table<char const*> table(first);
+        table.reserve(8);
+        CHECK(l.tabulate(first, last, table) == first + 14);
+
+        REQUIRE(table.size() == 4);
+        CHECK(table.categories()[0] == 1);
+        CHECK(table.categories()[1] == 2);
+        CHECK(table.offsets()[2] == 7);
+        CHECK(table.lengths()[2] == 6);
+        CHECK(table[3].first == first + 13);
+    }
+
+    // forward iterators
+    {
+        eggs::lexers::lexer<number, word> l;
+
+        std::list<char> const input_list(input.begin(), input.begin() + 6);
+
+        eggs::lexers::token_table<std::list<char>::const_iterator> table(
+            input_list.begin());
+        CHECK(l.tabulate(input_list.begin(), input_list.end(), table)
+            == input_list.end());
+
+        REQUIRE(table.size() == 1);
+        CHECK(table[0].first == input_list.begin());
+        CHECK(table[0].second == input_list.end());
+    }
+
+    // no category
+    {
+        eggs::lexers::token_table<char const*> table(first);
+        table.emplace_back(
+            eggs::lexers::token<char const*>::no_category, 0, 3);
+        CHECK(table.categories()[0] == table.no_category);
+        CHECK(table[0].category()
+            == eggs::lexers::token<char const*>::no_category);
+    }
+}
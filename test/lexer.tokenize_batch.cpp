@@ -0,0 +1,103 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("lexer<Rules...>::tokenize_batch(Documents const&, Sink&&, parallel_options const&)", "[lexer.tokenize_batch]")
+{
+    eggs::lexers::lexer<number, word, punct> l;
+    using token = decltype(l)::token<char const*>;
+
+    // uneven document sizes, and some invalid ones
+    std::vector<std::string> storage;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        std::string document;
+        std::size_t const repeat = i % 100 == 0 ? 2000 : i % 7;
+        for (std::size_t j = 0; j < repeat; ++j)
+            document += std::to_string(i + j) + "abc!";
+        if (i % 13 == 0)
+            document += " invalid";
+        storage.push_back(document);
+    }
+    std::vector<std::string_view> documents(storage.begin(), storage.end());
+
+    for (std::size_t threads : {1u, 2u, 8u})
+    {
+        eggs::lexers::parallel_options opts;
+        opts.threads = threads;
+
+        std::vector<std::vector<token>> slots(documents.size());
+        std::vector<char const*> lasts(documents.size());
+        std::vector<int> calls(documents.size());
+        l.tokenize_batch(documents,
+            [&](std::size_t i, std::vector<token>& tokens, char const* last)
+            {
+                slots[i] = std::move(tokens);
+                lasts[i] = last;
+                ++calls[i];
+            }, opts);
+
+        bool ok = true;
+        for (std::size_t i = 0; i < documents.size(); ++i)
+        {
+            std::vector<token> expected;
+            char const* const last = l(
+                documents[i].data(), documents[i].data() + documents[i].size(),
+                std::back_inserter(expected));
+
+            ok = ok && calls[i] == 1 && lasts[i] == last
+                && slots[i].size() == expected.size();
+            for (std::size_t j = 0; ok && j < expected.size(); ++j)
+            {
+                ok = slots[i][j].category() == expected[j].category()
+                    && slots[i][j].first == expected[j].first
+                    && slots[i][j].second == expected[j].second;
+            }
+        }
+        CHECK(ok);
+    }
+
+    // exception
+    {
+        eggs::lexers::parallel_options opts;
+        opts.threads = 4;
+
+        CHECK_THROWS_AS(
+            l.tokenize_batch(documents,
+                [&](std::size_t i, std::vector<token>&, char const*)
+                {
+                    if (i == 500)
+                        throw std::runtime_error("sink");
+                }, opts),
+            std::runtime_error const&);
+    }
+
+    // empty batch
+    {
+        std::vector<std::string_view> const none;
+
+        bool called = false;
+        l.tokenize_batch(none,
+            [&](std::size_t, std::vector<token>&, char const*)
+            {
+                called = true;
+            });
+        CHECK_FALSE(called);
+    }
+}
@@ -0,0 +1,149 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/char_set.hpp>
+#include <eggs/lexer/lexer.hpp>
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct digits : eggs::lexers::char_class_rule
+{
+    digits()
+      : char_class_rule("0123456789")
+    {}
+};
+
+struct alnums : eggs::lexers::char_class_rule
+{
+    alnums()
+      : char_class_rule(eggs::lexers::char_set()
+            .insert('0', '9').insert('a', 'z').insert('A', 'Z'))
+    {}
+};
+
+struct puncts : eggs::lexers::char_class_rule
+{
+    puncts()
+      : char_class_rule(".,;:!?-")
+    {}
+};
+
+struct spaces : eggs::lexers::char_class_rule
+{
+    spaces()
+      : char_class_rule(" \t")
+    {}
+};
+
+template <typename Lexer, typename Records>
+bool lanes_match(Lexer const& l, Records const& records)
+{
+    using iterator = decltype(std::begin(records[0]));
+    using token = typename Lexer::template token<iterator>;
+
+    std::vector<std::vector<token>> slots(records.size());
+    std::vector<iterator> lasts(records.size());
+    std::vector<int> calls(records.size());
+    l.tokenize_lanes(records,
+        [&](std::size_t i, std::vector<token>& tokens, iterator last)
+        {
+            slots[i] = std::move(tokens);
+            lasts[i] = last;
+            ++calls[i];
+        });
+
+    for (std::size_t i = 0; i < records.size(); ++i)
+    {
+        std::vector<token> expected;
+        iterator const last = l(
+            std::begin(records[i]), std::end(records[i]),
+            std::back_inserter(expected));
+
+        if (calls[i] != 1 || lasts[i] != last
+         || slots[i].size() != expected.size())
+            return false;
+        for (std::size_t j = 0; j < expected.size(); ++j)
+        {
+            if (slots[i][j].category() != expected[j].category()
+             || slots[i][j].first != expected[j].first
+             || slots[i][j].second != expected[j].second)
+                return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE("char_class_rule::operator()(Iterator, Sentinel)", "[lexer.tokenize_lanes]")
+{
+    char const input[] = "123abc";
+
+    digits const rule;
+
+    CHECK(rule(input + 0, input + 6) == input + 3);
+    CHECK(rule(input + 3, input + 6) == input + 3);
+    CHECK(rule(input + 0, input + 2) == input + 2);
+    CHECK(rule.set().contains('7'));
+}
+
+TEST_CASE("lexer<Rules...>::tokenize_lanes(Records const&, Sink&&)", "[lexer.tokenize_lanes]")
+{
+    std::vector<std::string> records;
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        std::string record = std::to_string(i * 7919);
+        record += i % 3 == 0 ? " abc" + std::to_string(i) : "";
+        record += i % 4 == 0 ? "!? " : ",";
+        record += std::string(i % 11, 'x');
+        if (i % 17 == 0)
+            record += "\n invalid";
+        if (i % 19 == 0)
+            record.clear();
+        records.push_back(record);
+    }
+
+    // lanes
+    {
+        eggs::lexers::lexer<digits, alnums, puncts, spaces> l;
+        CHECK(lanes_match(l, records));
+    }
+
+    // a single record
+    {
+        eggs::lexers::lexer<digits, alnums, puncts, spaces> l;
+        std::vector<std::string> const one(1, "123abc 45!");
+        CHECK(lanes_match(l, one));
+    }
+
+    // no records
+    {
+        eggs::lexers::lexer<digits, alnums, puncts, spaces> l;
+        std::vector<std::string> const none;
+        CHECK(lanes_match(l, none));
+    }
+
+    // forward iterators
+    {
+        eggs::lexers::lexer<digits, alnums, puncts, spaces> l;
+        std::vector<std::list<char>> lists;
+        for (std::string const& record : records)
+            lists.emplace_back(record.begin(), record.end());
+        CHECK(lanes_match(l, lists));
+    }
+
+    // other rules
+    {
+        eggs::lexers::lexer<number, word, punct> l;
+        CHECK(lanes_match(l, records));
+    }
+}
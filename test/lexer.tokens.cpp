@@ -0,0 +1,99 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#if __cpp_lib_ranges
+#include <ranges>
+#endif
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("lexer<Rules...>::tokens(Iterator, Sentinel)", "[lexer.tokens]")
+{
+    char const input[] = "123abc!12";
+
+    eggs::lexers::lexer<number, word, punct> l;
+
+    auto ts = l.tokens(input + 0, input + sizeof(input) - 1);
+
+    std::vector<eggs::lexers::token<char const*>> vs;
+    for (auto const& t : ts)
+        vs.push_back(t);
+
+    CHECK(ts.position() == input + 9);
+    REQUIRE(vs.size() == 3u);
+    CHECK(vs[0].category() == l.category_of<word>());
+    CHECK(vs[0].first == input + 0);
+    CHECK(vs[0].second == input + 6);
+    CHECK(vs[1].category() == l.category_of<punct>());
+    CHECK(vs[2].category() == l.category_of<number>());
+
+    // lazy
+    {
+        auto ts = l.tokens(input + 0, input + sizeof(input) - 1);
+
+        auto const iter = std::find_if(ts.begin(), ts.end(),
+            [&](auto const& t) { return t.category() == l.category_of<punct>(); });
+
+        REQUIRE(iter != ts.end());
+        CHECK(iter->first == input + 6);
+        CHECK(ts.position() == input + 7);
+    }
+
+    // postfix increment
+    {
+        auto ts = l.tokens(input + 0, input + sizeof(input) - 1);
+
+        auto iter = ts.begin();
+        auto const t = *iter++;
+        CHECK(t.category() == l.category_of<word>());
+        CHECK(iter->category() == l.category_of<punct>());
+    }
+
+    // invalid match
+    {
+        char const input[] = "123abc !";
+
+        auto ts = l.tokens(input + 0, input + sizeof(input) - 1);
+
+        CHECK(std::distance(ts.begin(), ts.end()) == 1);
+        CHECK(ts.position() == input + 6);
+    }
+
+    // empty input
+    {
+        char const input[] = "";
+
+        auto ts = l.tokens(input + 0, input + sizeof(input) - 1);
+
+        CHECK(ts.begin() == ts.end());
+        CHECK(ts.position() == input + 0);
+    }
+
+#if __cpp_lib_ranges
+    // views
+    {
+        auto numbers = l.tokens(input + 0, input + sizeof(input) - 1)
+          | std::views::filter([&](auto const& t) {
+                return t.category() != l.category_of<punct>(); })
+          | std::views::take(1);
+
+        std::vector<eggs::lexers::token<char const*>> vs;
+        for (auto const& t : numbers)
+            vs.push_back(t);
+
+        REQUIRE(vs.size() == 1u);
+        CHECK(vs[0].category() == l.category_of<word>());
+    }
+#endif
+}
@@ -0,0 +1,91 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/mapped_file.hpp>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+#include "temporary_file.hpp"
+
+TEST_CASE("mapped_file::mapped_file()", "[mapped_file.cnstr]")
+{
+    eggs::lexers::mapped_file const f;
+
+    CHECK(f.data() == nullptr);
+    CHECK(f.size() == 0u);
+    CHECK(f.empty());
+    CHECK(f.begin() == f.end());
+}
+
+TEST_CASE("mapped_file::mapped_file(char const*, options const&)", "[mapped_file.cnstr]")
+{
+    std::string contents;
+    for (int i = 0; i < 5000; ++i)
+        contents += std::to_string(i) + "abc!";
+    temporary_file const tmp("mapped_file.cnstr.tmp", contents);
+
+    eggs::lexers::mapped_file::options opts;
+    opts.populate = true;
+    opts.padding = 8192;
+    eggs::lexers::mapped_file const f(tmp.path.c_str(), opts);
+
+    REQUIRE(f.size() == contents.size());
+    CHECK(std::string(f.begin(), f.end()) == contents);
+
+    // padding
+    bool zeros = true;
+    for (std::size_t i = 0; i < opts.padding; ++i)
+        zeros = zeros && f.end()[i] == '\0';
+    CHECK(zeros);
+
+    // lex
+    {
+        eggs::lexers::lexer<number, word, punct> l;
+
+        CHECK(l.validate(f.begin(), f.end()));
+        CHECK(l.count(f.begin(), f.end()).counts[2] == 5000u);
+    }
+
+    // move
+    {
+        eggs::lexers::mapped_file f(tmp.path.c_str());
+        char const* const data = f.data();
+
+        eggs::lexers::mapped_file g(std::move(f));
+        CHECK(f.data() == nullptr);
+        CHECK(g.data() == data);
+        CHECK(g.size() == contents.size());
+
+        f = std::move(g);
+        CHECK(f.data() == data);
+        CHECK(g.data() == nullptr);
+    }
+
+    // empty file
+    {
+        temporary_file const tmp("mapped_file.cnstr.empty.tmp", "");
+
+        eggs::lexers::mapped_file const f(tmp.path.c_str());
+
+        CHECK(f.empty());
+        REQUIRE(f.data() != nullptr);
+        CHECK(f.data()[0] == '\0');
+    }
+
+    // no such file
+    {
+        CHECK_THROWS_AS(
+            eggs::lexers::mapped_file("mapped_file.cnstr.missing.tmp"),
+            std::system_error const&);
+    }
+}
@@ -0,0 +1,287 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/decoder.hpp>
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/stream.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+struct lexeme
+{
+    std::size_t category;
+    std::string text;
+
+    template <typename Token>
+    lexeme(Token const& t)
+      : category(t.category())
+      , text(t.first, t.second)
+    {}
+
+    friend bool operator==(lexeme const& lhs, lexeme const& rhs)
+    {
+        return lhs.category == rhs.category && lhs.text == rhs.text;
+    }
+};
+
+// copies its input in pieces of at most `step` characters
+struct copy_decoder
+{
+    char const* first;
+    char const* last;
+    std::size_t step;
+
+    char* decode(char* out_first, char* out_last)
+    {
+        std::size_t const size = (std::min)({step,
+            static_cast<std::size_t>(last - first),
+            static_cast<std::size_t>(out_last - out_first)});
+        out_first = std::copy(first, first + size, out_first);
+        first += size;
+        return out_first;
+    }
+};
+
+struct throwing_decoder
+{
+    std::size_t calls;
+
+    char* decode(char* first, char* /*last*/)
+    {
+        if (++calls == 3)
+            throw std::runtime_error("corrupt");
+        *first = 'a';
+        return first + 1;
+    }
+};
+
+#if EGGS_LEXER_HAS_ZLIB
+static std::string gzip(std::string const& input)
+{
+    ::z_stream s{};
+    ::deflateInit2(&s, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+        Z_DEFAULT_STRATEGY);
+
+    std::string output(::deflateBound(&s, static_cast<::uLong>(input.size())), '\0');
+    s.next_in = reinterpret_cast<::Bytef*>(const_cast<char*>(input.data()));
+    s.avail_in = static_cast<::uInt>(input.size());
+    s.next_out = reinterpret_cast<::Bytef*>(&output[0]);
+    s.avail_out = static_cast<::uInt>(output.size());
+    ::deflate(&s, Z_FINISH);
+    output.resize(s.total_out);
+    ::deflateEnd(&s);
+    return output;
+}
+#endif
+
+#if EGGS_LEXER_HAS_ZSTD
+static std::string zstd(std::string const& input)
+{
+    std::string output(::ZSTD_compressBound(input.size()), '\0');
+    std::size_t const size = ::ZSTD_compress(
+        &output[0], output.size(), input.data(), input.size(), 3);
+    REQUIRE_FALSE(::ZSTD_isError(size));
+    output.resize(size);
+    return output;
+}
+#endif
+
+TEST_CASE("pipelined_decoder<Decoder>::next()", "[pipelined_decoder.next]")
+{
+    std::string input;
+    for (int i = 0; i < 2000; ++i)
+        input += std::to_string(i * 7919) + "abc!" + std::string(i % 97, 'x') + "?";
+
+    for (std::size_t step : {1u, 7u, 1000u, 100000u})
+    {
+        using decoder = eggs::lexers::pipelined_decoder<copy_decoder>;
+        decoder::options opts;
+        opts.buffers = 3;
+        opts.buffer_size = 512;
+        decoder d(copy_decoder{input.data(), input.data() + input.size(), step}, opts);
+
+        std::string output;
+        for (;;)
+        {
+            std::pair<char const*, char const*> const chunk = d.next();
+            if (chunk.first == chunk.second)
+                break;
+
+            CHECK(std::size_t(chunk.second - chunk.first) <= opts.buffer_size);
+            output.append(chunk.first, chunk.second);
+        }
+        CHECK(output == input);
+
+        std::pair<char const*, char const*> const chunk = d.next();
+        CHECK(chunk.first == chunk.second);
+    }
+
+    // exception
+    {
+        eggs::lexers::pipelined_decoder<throwing_decoder>::options opts;
+        opts.buffer_size = 1;
+        eggs::lexers::pipelined_decoder<throwing_decoder> d(throwing_decoder{0}, opts);
+
+        std::pair<char const*, char const*> chunk = d.next();
+        CHECK(chunk.second - chunk.first == 1);
+        chunk = d.next();
+        CHECK(chunk.second - chunk.first == 1);
+        CHECK_THROWS_AS(d.next(), std::runtime_error const&);
+    }
+
+    // early destruction
+    {
+        eggs::lexers::pipelined_decoder<copy_decoder>::options opts;
+        opts.buffer_size = 16;
+        eggs::lexers::pipelined_decoder<copy_decoder> d(
+            copy_decoder{input.data(), input.data() + input.size(), 16}, opts);
+
+        CHECK(d.next().first != nullptr);
+    }
+}
+
+TEST_CASE("pipelined_decoder<Decoder>::for_each(chunked_lexer<Lexer>&, F&&)", "[pipelined_decoder.next]")
+{
+    using eggs::lexers::stream_status;
+
+    std::string input;
+    for (int i = 0; i < 2000; ++i)
+        input += std::to_string(i * 7919) + "abc!" + std::string(i % 97, 'x') + "?";
+
+    eggs::lexers::lexer<number, word, punct> l;
+
+    std::vector<lexeme> expected;
+    l(input.data(), input.data() + input.size(), std::back_inserter(expected));
+
+    {
+        using decoder = eggs::lexers::pipelined_decoder<copy_decoder>;
+        decoder::options opts;
+        opts.buffer_size = 100;
+        decoder d(copy_decoder{input.data(), input.data() + input.size(), 33}, opts);
+
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+        std::vector<lexeme> ts;
+        CHECK(d.for_each(cl, [&](auto const& t) { ts.push_back(t); })
+            == stream_status::exhausted);
+        CHECK(ts == expected);
+    }
+
+    // invalid match
+    {
+        std::string const bad = input + " " + input;
+
+        using decoder = eggs::lexers::pipelined_decoder<copy_decoder>;
+        decoder::options opts;
+        opts.buffer_size = 100;
+        decoder d(copy_decoder{bad.data(), bad.data() + bad.size(), 100}, opts);
+
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+        std::vector<lexeme> ts;
+        CHECK(d.for_each(cl, [&](auto const& t) { ts.push_back(t); })
+            == stream_status::error);
+        CHECK(ts == expected);
+        CHECK(cl.offset() == input.size());
+    }
+
+#if EGGS_LEXER_HAS_ZLIB
+    // gzip
+    {
+        std::string const compressed = gzip(input) + gzip(input);
+
+        using decoder = eggs::lexers::pipelined_decoder<eggs::lexers::gzip_decoder>;
+        decoder::options opts;
+        opts.buffer_size = 4096;
+        decoder d(eggs::lexers::gzip_decoder(
+            compressed.data(), compressed.data() + compressed.size()), opts);
+
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+        std::vector<lexeme> ts;
+        CHECK(d.for_each(cl, [&](auto const& t) { ts.push_back(t); })
+            == stream_status::exhausted);
+
+        std::vector<lexeme> expected_twice;
+        std::string const twice = input + input;
+        l(twice.data(), twice.data() + twice.size(),
+            std::back_inserter(expected_twice));
+        CHECK(ts == expected_twice);
+    }
+
+    // truncated gzip
+    {
+        std::string const compressed = gzip(input);
+
+        eggs::lexers::pipelined_decoder<eggs::lexers::gzip_decoder> d(
+            eggs::lexers::gzip_decoder(
+                compressed.data(), compressed.data() + compressed.size() / 2));
+
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+        CHECK_THROWS_AS(
+            d.for_each(cl, [](auto const&) {}),
+            std::runtime_error const&);
+    }
+#endif
+
+#if EGGS_LEXER_HAS_ZSTD
+    // zstd
+    {
+        std::string const compressed = zstd(input) + zstd(input);
+
+        using decoder = eggs::lexers::pipelined_decoder<eggs::lexers::zstd_decoder>;
+        decoder::options opts;
+        opts.buffer_size = 4096;
+        decoder d(eggs::lexers::zstd_decoder(
+            compressed.data(), compressed.data() + compressed.size()), opts);
+
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+        std::vector<lexeme> ts;
+        CHECK(d.for_each(cl, [&](auto const& t) { ts.push_back(t); })
+            == stream_status::exhausted);
+
+        std::vector<lexeme> expected_twice;
+        std::string const twice = input + input;
+        l(twice.data(), twice.data() + twice.size(),
+            std::back_inserter(expected_twice));
+        CHECK(ts == expected_twice);
+    }
+
+    // zstd, decoded directly
+    {
+        std::string const compressed = zstd(input);
+        eggs::lexers::zstd_decoder d(
+            compressed.data(), compressed.data() + compressed.size());
+
+        std::string output;
+        char buffer[1000];
+        for (char* last; (last = d.decode(buffer, buffer + sizeof(buffer))) != buffer;)
+            output.append(buffer, last);
+        CHECK(output == input);
+        CHECK(d.decode(buffer, buffer + sizeof(buffer)) == buffer);
+    }
+
+    // truncated zstd
+    {
+        std::string const compressed = zstd(input);
+
+        eggs::lexers::pipelined_decoder<eggs::lexers::zstd_decoder> d(
+            eggs::lexers::zstd_decoder(
+                compressed.data(), compressed.data() + compressed.size() / 2));
+
+        eggs::lexers::chunked_lexer<decltype(l)> cl(l);
+        CHECK_THROWS_AS(
+            d.for_each(cl, [](auto const&) {}),
+            std::runtime_error const&);
+    }
+#endif
+}
@@ -0,0 +1,71 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/pipeline.hpp>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+TEST_CASE("spsc_queue<T>::pop(T&)", "[spsc_queue.pop]")
+{
+    // single thread
+    {
+        eggs::lexers::spsc_queue<std::unique_ptr<int>> q(2);
+        CHECK(q.capacity() == 2);
+
+        std::unique_ptr<int> v;
+        CHECK_FALSE(q.try_pop(v));
+
+        CHECK(q.try_push(std::make_unique<int>(1)));
+        CHECK(q.try_push(std::make_unique<int>(2)));
+
+        std::unique_ptr<int> full = std::make_unique<int>(3);
+        CHECK_FALSE(q.try_push(std::move(full)));
+        CHECK(full != nullptr);
+
+        CHECK(q.try_pop(v));
+        CHECK(*v == 1);
+        CHECK(q.try_push(std::move(full)));
+        CHECK(full == nullptr);
+
+        q.close();
+        CHECK(q.pop(v));
+        CHECK(*v == 2);
+        CHECK(q.pop(v));
+        CHECK(*v == 3);
+        CHECK_FALSE(q.pop(v));
+    }
+
+    // producer and consumer
+    for (std::size_t capacity : {1u, 3u, 64u})
+    {
+        std::size_t const n = 100000;
+        eggs::lexers::spsc_queue<std::size_t> q(capacity);
+
+        std::thread producer([&]
+        {
+            for (std::size_t i = 0; i < n; ++i)
+                q.push(std::size_t(i));
+            q.close();
+        });
+
+        std::vector<std::size_t> values;
+        std::size_t v = 0;
+        while (q.pop(v))
+            values.push_back(v);
+        producer.join();
+
+        bool ok = values.size() == n;
+        for (std::size_t i = 0; ok && i < n; ++i)
+            ok = values[i] == i;
+        CHECK(ok);
+    }
+}
@@ -0,0 +1,39 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef TEMPORARY_FILE_HPP
+#define TEMPORARY_FILE_HPP
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+///////////////////////////////////////////////////////////////////////////////
+// a file named `name` within the temporary directory, holding `contents`,
+// which is removed on destruction
+struct temporary_file
+{
+    std::string path;
+
+    temporary_file(std::string const& name, std::string const& contents)
+      : path((std::filesystem::temp_directory_path() / name).string())
+    {
+        std::FILE* const file = std::fopen(path.c_str(), "wb");
+        std::fwrite(contents.data(), 1, contents.size(), file);
+        std::fclose(file);
+    }
+
+    temporary_file(temporary_file const&) = delete;
+    temporary_file& operator=(temporary_file const&) = delete;
+
+    ~temporary_file()
+    {
+        std::remove(path.c_str());
+    }
+};
+
+#endif /*TEMPORARY_FILE_HPP*/
@@ -0,0 +1,101 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/stream.hpp>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+TEST_CASE("token_generator<Lexer>::next()", "[token_generator.next]")
+{
+    using eggs::lexers::stream_status;
+
+    eggs::lexers::lexer<number, word, punct> l;
+    eggs::lexers::token_generator<decltype(l)> g(l);
+
+    CHECK(!g.next());
+    CHECK(g.status() == stream_status::suspended);
+
+    char const first[] = "123ab";
+    g.feed(first + 0, first + sizeof(first) - 1);
+
+    // the word may continue in the next chunk
+    CHECK(!g.next());
+    CHECK(g.status() == stream_status::suspended);
+
+    char const second[] = "c!12";
+    g.feed(second + 0, second + sizeof(second) - 1);
+
+    auto t = g.next();
+    REQUIRE(t);
+    CHECK(t->category() == l.category_of<word>());
+    CHECK(std::string(t->first, t->second) == "123abc");
+
+    t = g.next();
+    REQUIRE(t);
+    CHECK(t->category() == l.category_of<punct>());
+    CHECK(std::string(t->first, t->second) == "!");
+
+    CHECK(!g.next());
+    CHECK(g.status() == stream_status::suspended);
+
+    g.finish();
+
+    t = g.next();
+    REQUIRE(t);
+    CHECK(t->category() == l.category_of<number>());
+    CHECK(std::string(t->first, t->second) == "12");
+
+    CHECK(!g.next());
+    CHECK(g.status() == stream_status::exhausted);
+
+    // invalid match
+    {
+        eggs::lexers::token_generator<decltype(l)> g(l);
+
+        char const input[] = "abc !";
+        g.feed(input + 0, input + sizeof(input) - 1);
+
+        t = g.next();
+        REQUIRE(t);
+        CHECK(t->category() == l.category_of<word>());
+
+        CHECK(!g.next());
+        CHECK(g.status() == stream_status::error);
+        CHECK(*g.position() == ' ');
+    }
+
+    // one character at a time
+    {
+        eggs::lexers::token_generator<decltype(l)> g(l);
+
+        char const input[] = "12ab!?x";
+
+        std::vector<std::string> ts;
+        for (char const* iter = input; *iter != '\0'; ++iter)
+        {
+            g.feed(iter, iter + 1);
+            while (auto t = g.next())
+                ts.emplace_back(t->first, t->second);
+            CHECK(g.status() == stream_status::suspended);
+        }
+        g.finish();
+        while (auto t = g.next())
+            ts.emplace_back(t->first, t->second);
+        CHECK(g.status() == stream_status::exhausted);
+
+        REQUIRE(ts.size() == 4u);
+        CHECK(ts[0] == "12ab");
+        CHECK(ts[1] == "!");
+        CHECK(ts[2] == "?");
+        CHECK(ts[3] == "x");
+    }
+}
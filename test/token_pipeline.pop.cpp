@@ -0,0 +1,140 @@
+// Eggs.Lexer
+//
+// Copyright Agustin K-ballo Berge, Fusion Fenix 2017
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <eggs/lexer/lexer.hpp>
+#include <eggs/lexer/pipeline.hpp>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+#include "rules.hpp"
+
+// throws when it sees a '#'
+struct hash_throws
+{
+    template <typename I, typename S>
+    I operator()(I first, S /*last*/) const
+    {
+        if (*first == '#')
+            throw std::runtime_error("hash");
+        return first;
+    }
+};
+
+TEST_CASE("token_pipeline<Lexer, Iterator, Sentinel>::pop(batch&)", "[token_pipeline.pop]")
+{
+    eggs::lexers::lexer<number, word, punct> l;
+    using pipeline = eggs::lexers::token_pipeline<decltype(l), char const*>;
+
+    std::string input;
+    for (std::size_t i = 0; i < 10000; ++i)
+        input += std::to_string(i) + "abc!";
+    input += " invalid";
+    char const* const first = input.data();
+    char const* const last = input.data() + input.size();
+
+    std::vector<pipeline::token> expected;
+    char const* const expected_last = l(first, last, std::back_inserter(expected));
+
+    for (std::size_t batch_size : {1u, 7u, 1024u})
+    {
+        pipeline::options opts;
+        opts.capacity = 2;
+        opts.batch_size = batch_size;
+        pipeline p(l, first, last, opts);
+
+        std::vector<pipeline::token> tokens;
+        pipeline::batch batch;
+        bool ok = true;
+        while (p.pop(batch))
+        {
+            ok = ok && !batch.empty() && batch.size() <= batch_size;
+            tokens.insert(tokens.end(), batch.begin(), batch.end());
+        }
+        CHECK(ok);
+        CHECK(batch.empty());
+        CHECK(p.last() == expected_last);
+
+        REQUIRE(tokens.size() == expected.size());
+        for (std::size_t i = 0; ok && i < expected.size(); ++i)
+        {
+            ok = tokens[i].category() == expected[i].category()
+                && tokens[i].first == expected[i].first
+                && tokens[i].second == expected[i].second;
+        }
+        CHECK(ok);
+    }
+
+    // empty input
+    {
+        pipeline p(l, first, first);
+
+        pipeline::batch batch;
+        CHECK_FALSE(p.pop(batch));
+        CHECK(p.last() == first);
+    }
+
+    // abandoned before the end
+    {
+        pipeline::options opts;
+        opts.capacity = 1;
+        opts.batch_size = 1;
+        pipeline p(l, first, last, opts);
+
+        pipeline::batch batch;
+        CHECK(p.pop(batch));
+        CHECK(batch.size() == 1);
+    }
+
+    // exception
+    {
+        eggs::lexers::lexer<number, hash_throws> lt;
+        using throwing_pipeline =
+            eggs::lexers::token_pipeline<decltype(lt), char const*>;
+
+        std::string const text = "1234#56";
+        throwing_pipeline::options opts;
+        opts.batch_size = 1;
+        throwing_pipeline p(lt, text.data(), text.data() + text.size(), opts);
+
+        throwing_pipeline::batch batch;
+        CHECK(p.pop(batch));
+        CHECK(std::string(batch.at(0).first, batch.at(0).second) == "1234");
+        CHECK_THROWS_AS(p.pop(batch), std::runtime_error const&);
+    }
+
+    // exception, within a batch
+    {
+        eggs::lexers::lexer<number, punct, hash_throws> lt;
+        using throwing_pipeline =
+            eggs::lexers::token_pipeline<decltype(lt), char const*>;
+
+        std::string const text = "1234!56#7";
+        throwing_pipeline p(lt, text.data(), text.data() + text.size());
+
+        throwing_pipeline::batch batch;
+        std::vector<std::string> lexemes;
+        CHECK_THROWS_AS(
+            [&]
+            {
+                while (p.pop(batch))
+                {
+                    for (auto const& t : batch)
+                        lexemes.emplace_back(t.first, t.second);
+                }
+            }(),
+            std::runtime_error const&);
+        REQUIRE(lexemes.size() == 3);
+        CHECK(lexemes[0] == "1234");
+        CHECK(lexemes[1] == "!");
+        CHECK(lexemes[2] == "56");
+    }
+}